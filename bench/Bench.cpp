@@ -0,0 +1,73 @@
+//
+// Created on 10/18/26.
+//
+
+#include "Bench.hpp"
+#include <cstdlib>
+#include <new>
+
+size_t benchAllocations = 0;
+size_t benchAllocatedBytes = 0;
+
+static const char *benchFilter = nullptr;
+
+/* --------------------------------------------------------------------------------- */
+/* Allocation Counting                                                               */
+/* --------------------------------------------------------------------------------- */
+void* operator new(size_t size) {
+	++benchAllocations;
+	benchAllocatedBytes += size;
+	void *ptr = std::malloc(size ? size : 1);
+	if (!ptr) {
+		throw std::bad_alloc();
+	}
+	return ptr;
+}
+
+void* operator new[](size_t size) {
+	return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+	std::free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept {
+	std::free(ptr);
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Reporting                                                                         */
+/* --------------------------------------------------------------------------------- */
+// returns if the benchmark name matches the filter given on the command line
+bool BenchSelected(const std::string &name) {
+	return !benchFilter || name.find(benchFilter) != std::string::npos;
+}
+
+// prints one result as a JSON line
+void BenchReport(const std::string &name, size_t ops, uint64_t elapsedNs, size_t allocations, size_t bytes) {
+	double perOp = ops ? 1.0 / static_cast<double>(ops) : 0.0;
+	std::printf("{\"name\":\"%s\",\"ops\":%zu,\"ns_per_op\":%.2f,\"allocs_per_op\":%.3f,\"bytes_per_op\":%.1f}\n",
+		name.c_str(), ops, static_cast<double>(elapsedNs) * perOp, static_cast<double>(allocations) * perOp,
+		static_cast<double>(bytes) * perOp);
+	std::fflush(stdout);
+}
+
+// runs every benchmark, or those whose name contains the first argument
+int main(int argc, char **argv) {
+	if (argc > 1) {
+		benchFilter = argv[1];
+	}
+	RunParserBenchmarks();
+	RunChannelBenchmarks();
+	ServerBench::Run();
+	return 0;
+}
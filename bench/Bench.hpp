@@ -0,0 +1,93 @@
+//
+// Created on 10/18/26.
+//
+
+#ifndef IRC_BENCH_H
+#define IRC_BENCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <time.h>
+
+// minimum measured time of a benchmark
+#define BENCH_MIN_TIME_NS 200000000ULL
+// upper bound of calls between two resets, keeps queued output of fan-out benchmarks bounded
+#define BENCH_DEFAULT_BATCH (1 << 20)
+
+// operator new calls & bytes since startup, counted by the replacements in Bench.cpp
+extern size_t benchAllocations;
+extern size_t benchAllocatedBytes;
+
+// keeps the compiler from dropping a result that is never read
+template <typename T>
+inline void DoNotOptimize(const T &value) {
+	asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// returns monotonic nanoseconds
+inline uint64_t BenchNow() {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + static_cast<uint64_t>(now.tv_nsec);
+}
+
+// returns if the benchmark name matches the filter given on the command line
+bool BenchSelected(const std::string &name);
+
+// prints one result as a JSON line
+void BenchReport(const std::string &name, size_t ops, uint64_t elapsedNs, size_t allocations, size_t bytes);
+
+// calls fn until BENCH_MIN_TIME_NS passed, each call performs opsPerCall operations
+// reset runs untimed after at most maxBatch calls & at the end
+template <typename Function, typename Reset>
+void RunBenchmark(const std::string &name, size_t opsPerCall, size_t maxBatch, Function fn, Reset reset) {
+	if (!BenchSelected(name)) {
+		return;
+	}
+	// warm up caches & lazily grown buffers
+	fn();
+	reset();
+
+	size_t calls = 0;
+	uint64_t elapsed = 0;
+	size_t allocations = 0;
+	size_t bytes = 0;
+	size_t batch = 1;
+	while (elapsed < BENCH_MIN_TIME_NS) {
+		size_t allocationsBefore = benchAllocations;
+		size_t bytesBefore = benchAllocatedBytes;
+		uint64_t start = BenchNow();
+		for (size_t i = 0; i < batch; ++i) {
+			fn();
+		}
+		elapsed += BenchNow() - start;
+		allocations += benchAllocations - allocationsBefore;
+		bytes += benchAllocatedBytes - bytesBefore;
+		calls += batch;
+		reset();
+		if (batch < maxBatch) {
+			batch = batch * 2 < maxBatch ? batch * 2 : maxBatch;
+		}
+	}
+	BenchReport(name, calls * opsPerCall, elapsed, allocations, bytes);
+}
+
+// same without anything to reset
+template <typename Function>
+void RunBenchmark(const std::string &name, size_t opsPerCall, Function fn) {
+	RunBenchmark(name, opsPerCall, BENCH_DEFAULT_BATCH, fn, [] {});
+}
+
+// benchmark groups
+void RunParserBenchmarks();
+void RunChannelBenchmarks();
+
+// drives private paths of the server, declared a friend by Server
+class ServerBench {
+	public:
+		static void Run();
+};
+
+#endif //IRC_BENCH_H
@@ -0,0 +1,89 @@
+//
+// Created on 10/18/26.
+//
+
+#include "Bench.hpp"
+#include "Channel.hpp"
+#include "ServerConfig.hpp"
+
+// channel sizes every membership benchmark runs at
+static const size_t channelSizes[] = {10, 1000, 100000};
+
+// returns a channel with members 0..size-1, every tenth one an operator
+static Channel makeChannel(size_t size) {
+	Channel channel;
+	channel.SetName("#bench");
+	for (size_t i = 0; i < size; ++i) {
+		ClientHandle user = {static_cast<int>(i), 0};
+		channel.AddUser(user);
+		if (i % 10 == 0) {
+			channel.MakeOperator(user);
+		}
+	}
+	return channel;
+}
+
+// joins & parts one extra member, the op is the pair
+static void benchAddRemove(size_t size) {
+	Channel channel = makeChannel(size);
+	ClientHandle user = {static_cast<int>(size), 0};
+	RunBenchmark("channel/add-remove/" + std::to_string(size), 1, [&] {
+		channel.AddUser(user);
+		channel.RemoveUser(user.fd);
+	});
+}
+
+// parts & rejoins a member from the middle of the list, the op is the pair
+static void benchRemoveAdd(size_t size) {
+	Channel channel = makeChannel(size);
+	ClientHandle user = {static_cast<int>(size / 2), 0};
+	RunBenchmark("channel/remove-add/" + std::to_string(size), 1, [&] {
+		channel.RemoveUser(user.fd);
+		channel.AddUser(user);
+	});
+}
+
+// asks for the operator status of every member in turn
+static void benchIsOperator(size_t size) {
+	Channel channel = makeChannel(size);
+	ClientHandle user = {0, 0};
+	RunBenchmark("channel/is-operator/" + std::to_string(size), 1, [&] {
+		DoNotOptimize(channel.IsUserOperator(user));
+		user.fd = (user.fd + 7) % static_cast<int>(size);
+	});
+}
+
+// walks every member like a channel broadcast does, the op is one member
+static void benchFanOut(size_t size) {
+	Channel channel = makeChannel(size);
+	RunBenchmark("channel/fan-out/" + std::to_string(size), size, [&] {
+		int sum = 0;
+		for (const ChannelMember &member : channel.GetMembers()) {
+			sum += member.fd;
+		}
+		DoNotOptimize(sum);
+	});
+}
+
+// stores a PRIVMSG into a full history, every append evicts the oldest line
+static void benchHistoryAppend() {
+	ChannelHistory history;
+	history.SetBudget(DEFAULT_HISTORY_BYTES);
+	std::string line = ":bench0!bench@127.0.0.1 PRIVMSG #bench :hello everyone in this channel\r\n";
+	uint64_t msgid = 0;
+	RunBenchmark("channel/history-append", 1, [&] {
+		++msgid;
+		history.Append(msgid, static_cast<int64_t>(msgid), line);
+	});
+}
+
+// channel membership & history benchmarks
+void RunChannelBenchmarks() {
+	for (size_t size : channelSizes) {
+		benchAddRemove(size);
+		benchRemoveAdd(size);
+		benchIsOperator(size);
+		benchFanOut(size);
+	}
+	benchHistoryAppend();
+}
@@ -0,0 +1,86 @@
+//
+// Created on 10/18/26.
+//
+
+#include "Bench.hpp"
+#include "Parser.hpp"
+#include "Server.hpp"
+#include "RecvBuffer.hpp"
+#include "BufferPool.hpp"
+#include "LineScanner.hpp"
+#include <cstring>
+
+// lines of a framing chunk, about what a bulk paste delivers in one recv
+#define FRAMING_LINES 256
+
+/* --------------------------------------------------------------------------------- */
+/* Parser                                                                            */
+/* --------------------------------------------------------------------------------- */
+// parses one line per call
+static void benchParse(const std::string &name, const std::string &line) {
+	Parser parser;
+	MessageView msg;
+	RunBenchmark(name, 1, [&] {
+		parser.Parse(line, msg);
+		DoNotOptimize(msg);
+	});
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Framing                                                                           */
+/* --------------------------------------------------------------------------------- */
+// returns FRAMING_LINES chat lines, every other one ending in a bare LF
+static std::string framingChunk() {
+	std::string chunk;
+	for (int i = 0; i < FRAMING_LINES; ++i) {
+		chunk += ":nick!user@host PRIVMSG #channel :line " + std::to_string(i) + " of a pasted block of text";
+		chunk += (i % 2) ? "\n" : "\r\n";
+	}
+	return chunk;
+}
+
+// receives a chunk into a pooled buffer & pops every line, one line per op
+static void benchRecvBuffer(const std::string &name, size_t recvSize) {
+	BufferPool pool;
+	RecvBuffer buffer(&pool);
+	std::string chunk = framingChunk();
+	RunBenchmark(name, FRAMING_LINES, [&] {
+		std::string_view line;
+		for (size_t offset = 0; offset < chunk.size(); offset += recvSize) {
+			size_t size = std::min(recvSize, chunk.size() - offset);
+			std::memcpy(buffer.Reserve(size), chunk.data() + offset, size);
+			buffer.Commit(size);
+			while (buffer.NextLine(line) == LINE_OK) {
+				DoNotOptimize(line);
+			}
+		}
+		buffer.ReleaseIfEmpty();
+	});
+}
+
+// finds every terminator of a chunk without buffering, one line per op
+static void benchFindLineFeed(const std::string &name) {
+	std::string chunk = framingChunk();
+	RunBenchmark(name, FRAMING_LINES, [&] {
+		const char *data = chunk.data();
+		size_t size = chunk.size();
+		size_t pos;
+		while ((pos = LineScanner::FindLineFeed(data, size)) != std::string_view::npos) {
+			DoNotOptimize(pos);
+			data += pos + 1;
+			size -= pos + 1;
+		}
+	});
+}
+
+// parser & receive path benchmarks
+void RunParserBenchmarks() {
+	benchParse("parser/privmsg", ":nick!user@host PRIVMSG #channel :hello there, how is everyone doing today");
+	benchParse("parser/join", "JOIN #channel key");
+	benchParse("parser/max-params", "MODE #c +ooooooooooooo a b c d e f g h i j k l m n o p");
+	benchParse("parser/too-long", "PRIVMSG #channel :" + std::string(600, 'x'));
+	benchFindLineFeed(std::string("framing/find-line-feed/") + LineScanner::GetVariant());
+	// reads of the size HandleConnection uses & of a large io_uring buffer
+	benchRecvBuffer("framing/recv-buffer/" + std::to_string(MAX_BUFFER_SIZE), MAX_BUFFER_SIZE);
+	benchRecvBuffer("framing/recv-buffer/16384", 16384);
+}
@@ -0,0 +1,117 @@
+//
+// Created on 10/18/26.
+//
+
+#include "Bench.hpp"
+#include "Server.hpp"
+
+// first fd handed to simulated clients, they never see any I/O
+#define BENCH_CLIENT_FD 64
+// lines of a handle-input chunk
+#define BENCH_INPUT_LINES 64
+// queued lines the fan-out benchmarks may accumulate before their queues are dropped
+#define BENCH_QUEUED_LINES (1 << 18)
+
+// member counts of the broadcast benchmarks
+static const size_t broadcastSizes[] = {10, 1000, 10000};
+// channel counts of the lookup benchmarks
+static const size_t channelCounts[] = {100, 100000};
+
+// returns a server on an ephemeral port whose send queues never trigger a flush or an eviction
+static Server* makeServer() {
+	ServerConfig config;
+	config.sendqHighWater = static_cast<size_t>(1) << 40;
+	config.sendqLimit = static_cast<size_t>(1) << 41;
+	// the startup banner would break the JSON lines on stdout
+	std::streambuf *out = std::cout.rdbuf(nullptr);
+	Server *server = new Server(0, "bench", config);
+	std::cout.rdbuf(out);
+	return server;
+}
+
+// closes the listening socket the destructor leaves open
+static void destroyServer(Server *server) {
+	close(server->GetSocket());
+	delete server;
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Server Benchmarks                                                                 */
+/* --------------------------------------------------------------------------------- */
+// runs every server benchmark
+void ServerBench::Run() {
+	// framing, parsing & dispatch of a received chunk of PINGs, one line per op
+	{
+		Server *server = makeServer();
+		int fd = BENCH_CLIENT_FD;
+		server->_clients.Insert(fd, Client(fd, &server->_recvPool)).SetNickName("bench");
+		std::string chunk;
+		for (int i = 0; i < BENCH_INPUT_LINES; ++i) {
+			chunk += "PING :bench\r\n";
+		}
+		RunBenchmark("server/handle-input", BENCH_INPUT_LINES, BENCH_QUEUED_LINES / BENCH_INPUT_LINES, [&] {
+			server->_handleInput(fd, chunk.data(), chunk.size());
+			// the run loop resets the arena after every iteration, the benchmark never enters it
+			server->_arena.Reset();
+		}, [&] {
+			server->_clients[fd].TakeSendQueue();
+		});
+		destroyServer(server);
+	}
+
+	// a numeric rendered into the send queue, one reply per op
+	{
+		Server *server = makeServer();
+		int fd = BENCH_CLIENT_FD;
+		server->_clients.Insert(fd, Client(fd, &server->_recvPool)).SetNickName("bench");
+		RunBenchmark("server/numeric-reply", 1, BENCH_QUEUED_LINES, [&] {
+			server->_reply(fd, ERR_NOSUCHCHANNEL, {"#bench"});
+		}, [&] {
+			server->_clients[fd].TakeSendQueue();
+		});
+		destroyServer(server);
+	}
+
+	// one channel line queued to every member, one broadcast per op
+	for (size_t size : broadcastSizes) {
+		Server *server = makeServer();
+		Channel &channel = server->_channels["#bench"];
+		channel.SetName("#bench");
+		for (size_t i = 0; i < size; ++i) {
+			int fd = BENCH_CLIENT_FD + static_cast<int>(i);
+			server->_clients.Insert(fd, Client(fd, &server->_recvPool)).SetNickName("bench" + std::to_string(i));
+			channel.AddUser(server->_clients.GetHandle(fd));
+		}
+		std::string line = ":bench0!bench@127.0.0.1 PRIVMSG #bench :hello everyone in this channel\r\n";
+		RunBenchmark("server/broadcast/" + std::to_string(size), 1, BENCH_QUEUED_LINES / size, [&] {
+			server->_BroadcastToChannel(channel, line);
+		}, [&] {
+			for (size_t i = 0; i < size; ++i) {
+				server->_clients[BENCH_CLIENT_FD + static_cast<int>(i)].TakeSendQueue();
+			}
+		});
+		destroyServer(server);
+	}
+
+	// channel lookup by a name in another case, one lookup per op
+	for (size_t count : channelCounts) {
+		Server *server = makeServer();
+		std::vector<std::string> names;
+		for (size_t i = 0; i < count; ++i) {
+			server->_channels["#Bench" + std::to_string(i)].SetName("#Bench" + std::to_string(i));
+		}
+		for (size_t i = 0; i < BENCH_INPUT_LINES; ++i) {
+			names.push_back("#bENCH" + std::to_string(i * 7919 % count));
+		}
+		size_t found = 0;
+		RunBenchmark("server/channel-lookup/" + std::to_string(count), BENCH_INPUT_LINES, [&] {
+			for (size_t i = 0; i < names.size(); ++i) {
+				found += server->_findChannel(names[i]) != nullptr;
+			}
+		});
+		if (found == 0) {
+			std::cerr << "channel-lookup found nothing" << std::endl;
+		}
+		destroyServer(server);
+	}
+}
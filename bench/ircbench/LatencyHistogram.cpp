@@ -0,0 +1,80 @@
+//
+// Created on 10/18/26.
+//
+
+#include "LatencyHistogram.hpp"
+#include <cmath>
+
+/* --------------------------------------------------------------------------------- */
+/* Constructors & Destructors                                                        */
+/* --------------------------------------------------------------------------------- */
+LatencyHistogram::LatencyHistogram()
+	: _buckets((64 - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_BUCKETS, 0), _count(0), _max(0) {}
+
+LatencyHistogram::~LatencyHistogram() {}
+
+/* --------------------------------------------------------------------------------- */
+/* Buckets                                                                           */
+/* --------------------------------------------------------------------------------- */
+// returns the bucket of a value, values below HISTOGRAM_SUB_BUCKETS get one each
+size_t LatencyHistogram::_bucketOf(uint64_t value) {
+	if (value < HISTOGRAM_SUB_BUCKETS) {
+		return static_cast<size_t>(value);
+	}
+	int msb = 63 - __builtin_clzll(value);
+	size_t group = static_cast<size_t>(msb - HISTOGRAM_SUB_BITS + 1);
+	size_t sub = static_cast<size_t>((value >> (msb - HISTOGRAM_SUB_BITS)) & (HISTOGRAM_SUB_BUCKETS - 1));
+	return group * HISTOGRAM_SUB_BUCKETS + sub;
+}
+
+// returns the lowest value of a bucket
+uint64_t LatencyHistogram::_valueOf(size_t bucket) {
+	size_t group = bucket / HISTOGRAM_SUB_BUCKETS;
+	uint64_t sub = bucket % HISTOGRAM_SUB_BUCKETS;
+	if (group == 0) {
+		return sub;
+	}
+	return (HISTOGRAM_SUB_BUCKETS + sub) << (group - 1);
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Samples                                                                           */
+/* --------------------------------------------------------------------------------- */
+// records one sample
+void LatencyHistogram::Add(uint64_t value) {
+	++_buckets[_bucketOf(value)];
+	++_count;
+	if (value > _max) {
+		_max = value;
+	}
+}
+
+// returns the number of samples
+size_t LatencyHistogram::GetCount() const {
+	return _count;
+}
+
+// returns the largest sample
+uint64_t LatencyHistogram::GetMax() const {
+	return _max;
+}
+
+// returns the smallest value at or above the given fraction (0..1) of the samples
+uint64_t LatencyHistogram::GetPercentile(double fraction) const {
+	if (_count == 0) {
+		return 0;
+	}
+	size_t rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(_count)));
+	if (rank == 0) {
+		rank = 1;
+	}
+	size_t seen = 0;
+	for (size_t i = 0; i < _buckets.size(); ++i) {
+		seen += _buckets[i];
+		if (seen >= rank) {
+			uint64_t value = _valueOf(i);
+			return value < _max ? value : _max;
+		}
+	}
+	return _max;
+}
@@ -0,0 +1,37 @@
+//
+// Created on 10/18/26.
+//
+
+#ifndef IRC_LATENCYHISTOGRAM_H
+#define IRC_LATENCYHISTOGRAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// sub buckets per power of two, bounds the relative error of a percentile to 1/32
+#define HISTOGRAM_SUB_BITS 5
+#define HISTOGRAM_SUB_BUCKETS (1 << HISTOGRAM_SUB_BITS)
+
+// log linear histogram of nanosecond samples, constant memory however many messages are measured
+class LatencyHistogram {
+	public:
+		LatencyHistogram();
+		~LatencyHistogram();
+
+		void Add(uint64_t value);
+		size_t GetCount() const;
+		uint64_t GetMax() const;
+//		returns the smallest value at or above the given fraction (0..1) of the samples
+		uint64_t GetPercentile(double fraction) const;
+
+	private:
+		static size_t _bucketOf(uint64_t value);
+		static uint64_t _valueOf(size_t bucket);
+
+		std::vector<size_t> _buckets;
+		size_t _count;
+		uint64_t _max;
+};
+
+#endif //IRC_LATENCYHISTOGRAM_H
@@ -0,0 +1,512 @@
+//
+// Created on 10/18/26.
+//
+
+#include "LoadGenerator.hpp"
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <stdexcept>
+
+// sends scheduled per loop iteration at most, keeps reads flowing at very high rates
+#define IRCBENCH_MAX_SENDS_PER_TICK 4096
+
+/* --------------------------------------------------------------------------------- */
+/* Constructors & Destructors                                                        */
+/* --------------------------------------------------------------------------------- */
+LoadGenerator::LoadGenerator(const LoadConfig &config)
+	: _config(config), _epollFd(-1), _clients(config.clients), _members(config.channels, 0), _opened(0),
+	_inProgress(0), _messageStart(0), _lastDelivery(0) {
+	if (_config.channels == 0) {
+		throw std::invalid_argument("--channels must be at least 1");
+	}
+	if (_config.joins > _config.channels) {
+		throw std::invalid_argument("--joins must not be larger than --channels");
+	}
+	// every client needs a descriptor, take as many as allowed
+	struct rlimit limit;
+	if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+		limit.rlim_cur = limit.rlim_max;
+		setrlimit(RLIMIT_NOFILE, &limit);
+	}
+	_epollFd = epoll_create1(EPOLL_CLOEXEC);
+	if (_epollFd == -1) {
+		throw std::runtime_error("Failed to create epoll instance");
+	}
+	for (size_t i = 0; i < _clients.size(); ++i) {
+		_clients[i].fd = -1;
+		_clients[i].state = LOAD_CLOSED;
+		_clients[i].nick = "bench" + std::to_string(i);
+		_clients[i].outputOffset = 0;
+		_clients[i].writeArmed = false;
+		_clients[i].joinsPending = 0;
+		_clients[i].nextChannel = 0;
+		_clients[i].sentSeq = 0;
+		_clients[i].deliveredSeq = 0;
+	}
+}
+
+LoadGenerator::~LoadGenerator() {
+	for (size_t i = 0; i < _clients.size(); ++i) {
+		if (_clients[i].fd != -1) {
+			close(_clients[i].fd);
+		}
+	}
+	if (_epollFd != -1) {
+		close(_epollFd);
+	}
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Phases                                                                            */
+/* --------------------------------------------------------------------------------- */
+// runs connect, join & message phases, returns false if a setup phase timed out
+bool LoadGenerator::Run() {
+	_report.rssStart = _readServerRss();
+	if (!_connectPhase()) {
+		return false;
+	}
+	_report.rssConnected = _readServerRss();
+	if (!_joinPhase()) {
+		return false;
+	}
+	_report.rssJoined = _readServerRss();
+	_messagePhase();
+	_drainPhase();
+	_report.rssEnd = _readServerRss();
+	return true;
+}
+
+// opens every client & completes PASS/NICK/USER, at most connectBatch at a time
+bool LoadGenerator::_connectPhase() {
+	uint64_t start = _now();
+	uint64_t deadline = start + _config.timeout * 1000000000ULL;
+	while (_opened < _clients.size() || _inProgress > 0) {
+		while (_opened < _clients.size() && _inProgress < _config.connectBatch) {
+			_openClient(_opened++);
+		}
+		_poll(10);
+		if (_now() > deadline) {
+			return false;
+		}
+	}
+	_report.connectSeconds = static_cast<double>(_now() - start) / 1e9;
+	return true;
+}
+
+// joins every registered client to its channels & waits for the topic replies
+bool LoadGenerator::_joinPhase() {
+	uint64_t start = _now();
+	uint64_t deadline = start + _config.timeout * 1000000000ULL;
+	for (size_t i = 0; i < _clients.size(); ++i) {
+		if (_clients[i].state != LOAD_REGISTERED || _config.joins == 0) {
+			continue;
+		}
+		_clients[i].state = LOAD_JOINING;
+		_clients[i].joinsPending = _config.joins;
+		++_inProgress;
+		for (size_t j = 0; j < _config.joins; ++j) {
+			_queue(i, "JOIN " + _channelName((i + j) % _config.channels) + "\r\n");
+		}
+	}
+	while (_inProgress > 0) {
+		_poll(10);
+		if (_now() > deadline) {
+			return false;
+		}
+	}
+	_report.joinSeconds = static_cast<double>(_now() - start) / 1e9;
+	return true;
+}
+
+// sends PRIVMSGs at the target rate, a client with a full window skips its turn
+void LoadGenerator::_messagePhase() {
+	uint64_t start = _now();
+	uint64_t end = start + _config.duration * 1000000000ULL;
+	_messageStart = start;
+	size_t attempted = 0;
+	size_t cursor = 0;
+	uint64_t now;
+	while ((now = _now()) < end) {
+		size_t due = static_cast<size_t>(static_cast<double>(_config.rate) * static_cast<double>(now - start) / 1e9);
+		size_t budget = IRCBENCH_MAX_SENDS_PER_TICK;
+		while (attempted < due && budget-- > 0) {
+			++attempted;
+			// next client that is still in its channels
+			size_t tries = 0;
+			while (tries < _clients.size() && _clients[cursor].state != LOAD_JOINED) {
+				cursor = (cursor + 1) % _clients.size();
+				++tries;
+			}
+			if (tries == _clients.size()) {
+				break;
+			}
+			if (!_sendMessage(cursor)) {
+				++_report.throttled;
+			}
+			cursor = (cursor + 1) % _clients.size();
+		}
+		_poll(1);
+	}
+	_report.messageSeconds = static_cast<double>(_now() - start) / 1e9;
+}
+
+// waits for messages still in flight, the message rate counts until the last delivery
+void LoadGenerator::_drainPhase() {
+	uint64_t deadline = _now() + _config.drain * 1000000000ULL;
+	while (_report.delivered < _report.expected && _now() < deadline) {
+		_poll(10);
+	}
+	double lastDelivery = static_cast<double>(_lastDelivery - _messageStart) / 1e9;
+	if (_lastDelivery > _messageStart && lastDelivery > _report.messageSeconds) {
+		_report.messageSeconds = lastDelivery;
+	}
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Connections                                                                       */
+/* --------------------------------------------------------------------------------- */
+// starts a non blocking connect
+void LoadGenerator::_openClient(size_t index) {
+	LoadClient &client = _clients[index];
+	client.fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (client.fd == -1) {
+		++_report.errors;
+		return;
+	}
+	int enable = 1;
+	setsockopt(client.fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+	struct sockaddr_in addr;
+	std::memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(_config.port);
+	inet_pton(AF_INET, _config.host.c_str(), &addr.sin_addr);
+
+	client.state = LOAD_CONNECTING;
+	++_inProgress;
+	if (connect(client.fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) == -1 && errno != EINPROGRESS) {
+		++_report.errors;
+		_closeClient(index);
+		return;
+	}
+	// writable once the connect completed
+	struct epoll_event event;
+	event.events = EPOLLIN | EPOLLOUT;
+	event.data.u64 = index;
+	epoll_ctl(_epollFd, EPOLL_CTL_ADD, client.fd, &event);
+	client.writeArmed = true;
+}
+
+// closes a client, a client still in a setup phase counts as finished
+void LoadGenerator::_closeClient(size_t index) {
+	LoadClient &client = _clients[index];
+	if (client.state == LOAD_CLOSED) {
+		return;
+	}
+	if (client.state == LOAD_CONNECTING || client.state == LOAD_REGISTERING || client.state == LOAD_JOINING) {
+		--_inProgress;
+	}
+	if (client.fd != -1) {
+		epoll_ctl(_epollFd, EPOLL_CTL_DEL, client.fd, nullptr);
+		close(client.fd);
+		client.fd = -1;
+	}
+	client.state = LOAD_CLOSED;
+	++_report.disconnects;
+}
+
+// waits for socket events & handles them
+void LoadGenerator::_poll(int timeoutMs) {
+	struct epoll_event events[IRCBENCH_MAX_EVENTS];
+	int count = epoll_wait(_epollFd, events, IRCBENCH_MAX_EVENTS, timeoutMs);
+	for (int i = 0; i < count; ++i) {
+		size_t index = static_cast<size_t>(events[i].data.u64);
+		if (events[i].events & (EPOLLOUT | EPOLLERR)) {
+			_handleWritable(index);
+		}
+		if (events[i].events & (EPOLLIN | EPOLLHUP) && _clients[index].state != LOAD_CLOSED) {
+			_handleReadable(index);
+		}
+	}
+}
+
+// completes a connect or continues a partial write
+void LoadGenerator::_handleWritable(size_t index) {
+	LoadClient &client = _clients[index];
+	if (client.state == LOAD_CONNECTING) {
+		int error = 0;
+		socklen_t length = sizeof(error);
+		if (getsockopt(client.fd, SOL_SOCKET, SO_ERROR, &error, &length) == -1 || error != 0) {
+			++_report.errors;
+			_closeClient(index);
+			return;
+		}
+		client.state = LOAD_REGISTERING;
+		client.output += "PASS " + _config.password + "\r\nNICK " + client.nick + "\r\nUSER " + client.nick +
+			" 0 * :ircbench\r\n";
+	}
+	if (client.state != LOAD_CLOSED) {
+		_flush(index);
+	}
+}
+
+// reads what the server sent & handles every complete line
+void LoadGenerator::_handleReadable(size_t index) {
+	LoadClient &client = _clients[index];
+	ssize_t bytesRead = recv(client.fd, _recvBuffer, sizeof(_recvBuffer), 0);
+	if (bytesRead <= 0) {
+		if (bytesRead == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+			_closeClient(index);
+		}
+		return;
+	}
+	client.input.append(_recvBuffer, static_cast<size_t>(bytesRead));
+	size_t start = 0;
+	size_t end;
+	while ((end = client.input.find('\n', start)) != std::string::npos) {
+		size_t length = end - start;
+		if (length > 0 && client.input[end - 1] == '\r') {
+			--length;
+		}
+		_handleLine(index, client.input.substr(start, length));
+		if (_clients[index].state == LOAD_CLOSED) {
+			return;
+		}
+		start = end + 1;
+	}
+	client.input.erase(0, start);
+}
+
+// reacts to one line from the server
+void LoadGenerator::_handleLine(size_t index, const std::string &line) {
+	LoadClient &client = _clients[index];
+	size_t pos = 0;
+	if (!line.empty() && line[0] == ':') {
+		pos = line.find(' ');
+		if (pos == std::string::npos) {
+			return;
+		}
+		++pos;
+	}
+	size_t commandEnd = line.find(' ', pos);
+	std::string command = line.substr(pos, commandEnd == std::string::npos ? std::string::npos : commandEnd - pos);
+	std::string rest = commandEnd == std::string::npos ? "" : line.substr(commandEnd + 1);
+
+	if (command == "PRIVMSG") {
+		size_t text = rest.find(" :");
+		if (text != std::string::npos) {
+			_handleDelivery(rest.substr(text + 2));
+		}
+	} else if (command == "PING") {
+		_queue(index, "PONG " + rest + "\r\n");
+	} else if (command == "001") {
+		if (client.state == LOAD_REGISTERING) {
+			client.state = LOAD_REGISTERED;
+			--_inProgress;
+			++_report.connected;
+		}
+	} else if (command == "331" || command == "332") {
+		// "<nick> <channel> :topic", only the joining client gets it
+		size_t channel = rest.find("#bench");
+		if (channel != std::string::npos) {
+			size_t id = std::strtoul(rest.c_str() + channel + 6, nullptr, 10);
+			if (id < _members.size()) {
+				++_members[id];
+			}
+		}
+		if (client.state == LOAD_JOINING && --client.joinsPending == 0) {
+			client.state = LOAD_JOINED;
+			--_inProgress;
+			++_report.joined;
+		}
+	} else if (command == "ERROR") {
+		_closeClient(index);
+	} else if (command.size() == 3 && (command[0] == '4' || command[0] == '5')) {
+		++_report.errors;
+		if (client.state == LOAD_REGISTERING) {
+			_closeClient(index);
+		} else if (client.state == LOAD_JOINING && --client.joinsPending == 0) {
+			client.state = LOAD_JOINED;
+			--_inProgress;
+			++_report.joined;
+		}
+	}
+}
+
+// records the latency of a delivered benchmark message "ircbench <sender> <seq> <sent ns>"
+void LoadGenerator::_handleDelivery(const std::string &text) {
+	size_t sender;
+	unsigned long long seq;
+	unsigned long long sentAt;
+	if (std::sscanf(text.c_str(), "ircbench %zu %llu %llu", &sender, &seq, &sentAt) != 3) {
+		return;
+	}
+	uint64_t now = _now();
+	_latency.Add(now > sentAt ? now - sentAt : 0);
+	++_report.delivered;
+	_lastDelivery = now;
+	if (sender < _clients.size() && seq > _clients[sender].deliveredSeq) {
+		_clients[sender].deliveredSeq = seq;
+	}
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Output                                                                            */
+/* --------------------------------------------------------------------------------- */
+// appends a line to the client's output & writes it unless the socket is full
+void LoadGenerator::_queue(size_t index, const std::string &line) {
+	LoadClient &client = _clients[index];
+	if (client.state == LOAD_CLOSED) {
+		return;
+	}
+	client.output += line;
+	if (!client.writeArmed) {
+		_flush(index);
+	}
+}
+
+// writes pending output, waits for writability if the socket is full
+void LoadGenerator::_flush(size_t index) {
+	LoadClient &client = _clients[index];
+	while (client.outputOffset < client.output.size()) {
+		ssize_t sent = send(client.fd, client.output.data() + client.outputOffset,
+			client.output.size() - client.outputOffset, MSG_NOSIGNAL);
+		if (sent < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			if (errno == EAGAIN || errno == EWOULDBLOCK) {
+				if (!client.writeArmed) {
+					struct epoll_event event;
+					event.events = EPOLLIN | EPOLLOUT;
+					event.data.u64 = index;
+					epoll_ctl(_epollFd, EPOLL_CTL_MOD, client.fd, &event);
+					client.writeArmed = true;
+				}
+				return;
+			}
+			_closeClient(index);
+			return;
+		}
+		client.outputOffset += static_cast<size_t>(sent);
+	}
+	client.output.clear();
+	client.outputOffset = 0;
+	if (client.writeArmed) {
+		struct epoll_event event;
+		event.events = EPOLLIN;
+		event.data.u64 = index;
+		epoll_ctl(_epollFd, EPOLL_CTL_MOD, client.fd, &event);
+		client.writeArmed = false;
+	}
+}
+
+// sends the next benchmark message of a client, false if its window is full
+bool LoadGenerator::_sendMessage(size_t index) {
+	LoadClient &client = _clients[index];
+	if (client.sentSeq - client.deliveredSeq >= _config.window) {
+		return false;
+	}
+	size_t channel = (index + client.nextChannel++ % _config.joins) % _config.channels;
+	++client.sentSeq;
+	if (_members[channel] < 2) {
+		// nobody else in the channel, there is nothing to wait for
+		client.deliveredSeq = client.sentSeq;
+	} else {
+		_report.expected += _members[channel] - 1;
+	}
+	++_report.sent;
+	_queue(index, "PRIVMSG " + _channelName(channel) + " :ircbench " + std::to_string(index) + " " +
+		std::to_string(client.sentSeq) + " " + std::to_string(_now()) + "\r\n");
+	return true;
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Report                                                                            */
+/* --------------------------------------------------------------------------------- */
+// prints the report as a single JSON object
+void LoadGenerator::PrintReport() const {
+	double connectRate = _report.connectSeconds > 0 ? static_cast<double>(_report.connected) / _report.connectSeconds : 0;
+	double messageRate = _report.messageSeconds > 0 ? static_cast<double>(_report.delivered) / _report.messageSeconds : 0;
+	double ratio = _report.expected ? static_cast<double>(_report.delivered) / static_cast<double>(_report.expected) : 0;
+	std::printf("{\"clients\":%zu,\"connected\":%zu,\"connect_seconds\":%.3f,\"connects_per_sec\":%.1f,"
+		"\"joined\":%zu,\"join_seconds\":%.3f,\"sent\":%zu,\"throttled\":%zu,\"expected\":%zu,\"delivered\":%zu,"
+		"\"delivery_ratio\":%.4f,\"msgs_per_sec\":%.1f,"
+		"\"latency_us\":{\"p50\":%.1f,\"p99\":%.1f,\"p999\":%.1f,\"max\":%.1f},"
+		"\"server_rss_kb\":{\"start\":%ld,\"connected\":%ld,\"joined\":%ld,\"end\":%ld},"
+		"\"errors\":%zu,\"disconnects\":%zu}\n",
+		_clients.size(), _report.connected, _report.connectSeconds, connectRate,
+		_report.joined, _report.joinSeconds, _report.sent, _report.throttled, _report.expected, _report.delivered,
+		ratio, messageRate,
+		static_cast<double>(_latency.GetPercentile(0.50)) / 1e3, static_cast<double>(_latency.GetPercentile(0.99)) / 1e3,
+		static_cast<double>(_latency.GetPercentile(0.999)) / 1e3, static_cast<double>(_latency.GetMax()) / 1e3,
+		_report.rssStart, _report.rssConnected, _report.rssJoined, _report.rssEnd,
+		_report.errors, _report.disconnects);
+	std::fflush(stdout);
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Helpers                                                                           */
+/* --------------------------------------------------------------------------------- */
+// returns the name of a benchmark channel
+std::string LoadGenerator::_channelName(size_t channel) const {
+	return "#bench" + std::to_string(channel);
+}
+
+// returns the resident set of the server in KiB, -1 if it cannot be read
+long LoadGenerator::_readServerRss() const {
+	int pid = _config.pid;
+	if (pid == 0) {
+		// the only process called ircserv
+		DIR *proc = opendir("/proc");
+		if (!proc) {
+			return -1;
+		}
+		struct dirent *entry;
+		while ((entry = readdir(proc)) != nullptr) {
+			int candidate = std::atoi(entry->d_name);
+			if (candidate <= 0) {
+				continue;
+			}
+			std::ifstream comm("/proc/" + std::string(entry->d_name) + "/comm");
+			std::string name;
+			if (std::getline(comm, name) && name == "ircserv") {
+				if (pid != 0) {
+					pid = -1;
+					break;
+				}
+				pid = candidate;
+			}
+		}
+		closedir(proc);
+		if (pid <= 0) {
+			return -1;
+		}
+	}
+	std::ifstream status("/proc/" + std::to_string(pid) + "/status");
+	std::string line;
+	while (std::getline(status, line)) {
+		if (line.compare(0, 6, "VmRSS:") == 0) {
+			return std::strtol(line.c_str() + 6, nullptr, 10);
+		}
+	}
+	return -1;
+}
+
+// returns monotonic nanoseconds
+uint64_t LoadGenerator::_now() {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + static_cast<uint64_t>(now.tv_nsec);
+}
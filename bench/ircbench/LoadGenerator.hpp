@@ -0,0 +1,134 @@
+//
+// Created on 10/18/26.
+//
+
+#ifndef IRC_LOADGENERATOR_H
+#define IRC_LOADGENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "LatencyHistogram.hpp"
+
+// bytes read per recv call
+#define IRCBENCH_RECV_SIZE 65536
+// events handled per epoll_wait
+#define IRCBENCH_MAX_EVENTS 1024
+
+// settings of one run, see the usage line of ircbench
+struct LoadConfig {
+	std::string host = "127.0.0.1";
+	uint16_t port = 6667;
+	std::string password;
+//	simulated clients
+	size_t clients = 100;
+//	connections being set up at the same time
+	size_t connectBatch = 256;
+//	channels #bench0..N-1 & how many of them every client joins, client i joins i..i+joins-1 (mod channels)
+	size_t channels = 1;
+	size_t joins = 1;
+//	PRIVMSGs per second over all clients & seconds to send them
+	size_t rate = 1000;
+	size_t duration = 10;
+//	messages a client may have in flight before it waits for one to be delivered
+	size_t window = 16;
+//	seconds each setup phase & the final drain may take
+	size_t timeout = 30;
+	size_t drain = 2;
+//	server process for RSS readings, 0 looks for a process called ircserv
+	int pid = 0;
+};
+
+enum LoadClientState {
+	LOAD_CONNECTING,
+	LOAD_REGISTERING,
+	LOAD_REGISTERED,
+	LOAD_JOINING,
+	LOAD_JOINED,
+	LOAD_CLOSED,
+};
+
+// one simulated connection
+struct LoadClient {
+	int fd;
+	LoadClientState state;
+	std::string nick;
+	std::string input;
+	std::string output;
+	size_t outputOffset;
+	bool writeArmed;
+	size_t joinsPending;
+	size_t nextChannel;
+//	sequence numbers of the last sent & the highest delivered message
+	uint64_t sentSeq;
+	uint64_t deliveredSeq;
+};
+
+// counters & timings of a run
+struct LoadReport {
+	size_t connected = 0;
+	double connectSeconds = 0;
+	size_t joined = 0;
+	double joinSeconds = 0;
+	size_t sent = 0;
+	size_t throttled = 0;
+	size_t expected = 0;
+	size_t delivered = 0;
+	double messageSeconds = 0;
+	size_t errors = 0;
+	size_t disconnects = 0;
+	long rssStart = -1;
+	long rssConnected = -1;
+	long rssJoined = -1;
+	long rssEnd = -1;
+};
+
+// closed loop load generator, all clients share one epoll event loop
+class LoadGenerator {
+	public:
+		explicit LoadGenerator(const LoadConfig &config);
+		~LoadGenerator();
+
+//		runs connect, join & message phases, returns false if a setup phase timed out
+		bool Run();
+//		prints the report as a single JSON object
+		void PrintReport() const;
+
+	private:
+		bool _connectPhase();
+		bool _joinPhase();
+		void _messagePhase();
+		void _drainPhase();
+
+		void _openClient(size_t index);
+		void _closeClient(size_t index);
+		void _poll(int timeoutMs);
+		void _handleWritable(size_t index);
+		void _handleReadable(size_t index);
+		void _handleLine(size_t index, const std::string &line);
+		void _handleDelivery(const std::string &text);
+		void _queue(size_t index, const std::string &line);
+		void _flush(size_t index);
+		bool _sendMessage(size_t index);
+
+		std::string _channelName(size_t channel) const;
+		long _readServerRss() const;
+		static uint64_t _now();
+
+		LoadConfig _config;
+		int _epollFd;
+		std::vector<LoadClient> _clients;
+//		members per channel, to know how many deliveries a message should cause
+		std::vector<size_t> _members;
+		size_t _opened;
+//		clients in a setup phase that neither finished nor failed yet
+		size_t _inProgress;
+		uint64_t _messageStart;
+		uint64_t _lastDelivery;
+		LatencyHistogram _latency;
+		LoadReport _report;
+		char _recvBuffer[IRCBENCH_RECV_SIZE];
+};
+
+#endif //IRC_LOADGENERATOR_H
@@ -0,0 +1,82 @@
+//
+// Created on 10/18/26.
+//
+
+#include "LoadGenerator.hpp"
+#include <iostream>
+#include <stdexcept>
+#include <csignal>
+
+// parses the optional "--option value" pairs following port & password
+static LoadConfig parseOptions(int argc, char **argv) {
+	LoadConfig config;
+	for (int i = 3; i < argc; i += 2) {
+		std::string option = argv[i];
+		if (i + 1 >= argc) {
+			throw std::invalid_argument("Missing value for option " + option);
+		}
+		std::string value = argv[i + 1];
+		if (option == "--host") {
+			config.host = value;
+		} else if (option == "--clients") {
+			config.clients = std::stoul(value);
+		} else if (option == "--connect-batch") {
+			config.connectBatch = std::stoul(value);
+		} else if (option == "--channels") {
+			config.channels = std::stoul(value);
+		} else if (option == "--joins") {
+			config.joins = std::stoul(value);
+		} else if (option == "--rate") {
+			config.rate = std::stoul(value);
+		} else if (option == "--duration") {
+			config.duration = std::stoul(value);
+		} else if (option == "--window") {
+			config.window = std::stoul(value);
+		} else if (option == "--timeout") {
+			config.timeout = std::stoul(value);
+		} else if (option == "--drain") {
+			config.drain = std::stoul(value);
+		} else if (option == "--pid") {
+			config.pid = std::stoi(value);
+		} else {
+			throw std::invalid_argument("Unknown option " + option);
+		}
+	}
+	if (config.connectBatch == 0 || config.window == 0) {
+		throw std::invalid_argument("--connect-batch and --window must be at least 1");
+	}
+	return config;
+}
+
+int main(int argc, char **argv) {
+	if (argc < 3 || argc % 2 == 0) {
+		std::cerr << "usage: ./ircbench <port> <password> [--host IP] [--clients N] [--connect-batch N]"
+			<< " [--channels N] [--joins N] [--rate MSGS_PER_SEC] [--duration S] [--window N]"
+			<< " [--timeout S] [--drain S] [--pid PID]" << std::endl;
+		return 1;
+	}
+
+	try {
+		size_t portSizeT = std::stoul(argv[1]);
+		if (portSizeT > UINT16_MAX) {
+			throw std::out_of_range("Port number out of range for uint16_t");
+		}
+		LoadConfig config = parseOptions(argc, argv);
+		config.port = static_cast<uint16_t>(portSizeT);
+		config.password = argv[2];
+
+		signal(SIGPIPE, SIG_IGN);
+		LoadGenerator generator(config);
+		bool completed = generator.Run();
+		generator.PrintReport();
+		if (!completed) {
+			std::cerr << "setup phase timed out" << std::endl;
+			return 1;
+		}
+	} catch (std::exception &e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,64 @@
+//
+// Created on 10/18/26.
+//
+
+#ifndef IRC_ADMISSION_H
+#define IRC_ADMISSION_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <ctime>
+#include "Enums.hpp"
+
+// length of the window --connect-rate counts connections in
+#define CONNECT_RATE_WINDOW 10
+
+// counters of the connection admission, never reset
+struct AdmissionStats {
+	size_t accepted;
+	size_t rejectedMaxClients;
+	size_t rejectedPerIp;
+	size_t rejectedRate;
+	size_t acceptErrors;
+};
+
+// per source address connection limits, kept in an open addressing table
+class Admission {
+	public:
+		Admission();
+		Admission(size_t maxPerIp, size_t connectRate);
+		~Admission();
+
+//		decides whether a new connection may stay & accounts for it if so
+		AdmissionResult Admit(uint32_t address, size_t currentClients, size_t maxClients, time_t now);
+//		forgets a closed connection of an admitted address
+		void Release(uint32_t address, time_t now);
+
+		void CountAcceptError();
+		const AdmissionStats& GetStats() const;
+		size_t GetTrackedAddresses() const;
+
+	private:
+//		12 bytes per tracked address, address 0 marks a free slot
+		struct Entry {
+			uint32_t address;
+			uint16_t connections;
+			uint16_t recentConnects;
+			uint32_t windowStart;
+		};
+
+		Entry* _find(uint32_t address);
+		Entry& _insert(uint32_t address, time_t now);
+		void _erase(Entry *entry);
+		void _rehash(size_t capacity, time_t now);
+		bool _isIdle(const Entry &entry, time_t now) const;
+
+		size_t _maxPerIp;
+		size_t _connectRate;
+		std::vector<Entry> _entries;
+		size_t _used;
+		AdmissionStats _stats;
+};
+
+#endif //IRC_ADMISSION_H
@@ -0,0 +1,100 @@
+//
+// Created on 10/18/26.
+//
+
+#ifndef IRC_ARENA_H
+#define IRC_ARENA_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <initializer_list>
+
+// bytes of one arena block, a command's temporaries fit in a fraction of it
+#define ARENA_BLOCK_SIZE 65536
+
+// occupancy of an arena
+struct ArenaStats {
+	size_t blocks;
+//	most bytes handed out between two resets
+	size_t peakBytes;
+	size_t oversized;
+};
+
+// bump allocator for temporaries that die within one event loop iteration
+// allocating moves a pointer, freeing is a no-op except for the latest allocation & Reset rewinds everything
+// blocks are kept across resets, so a steady state iteration never touches the global allocator
+class Arena {
+	public:
+		Arena();
+		~Arena();
+
+		void* Allocate(size_t size, size_t alignment);
+//		gives the bytes back if they are the latest allocation, which lets a growing string reuse its tail
+		void Deallocate(void *ptr, size_t size);
+//		invalidates everything allocated since the last reset
+		void Reset();
+
+//		copies the concatenation of parts into the arena
+		std::string_view Concat(std::initializer_list<std::string_view> parts);
+
+		const ArenaStats& GetStats() const;
+
+	private:
+		Arena(const Arena &);
+		Arena& operator=(const Arena &);
+
+		void _nextBlock();
+
+		std::vector<char *> _blocks;
+//		index of the block being filled & bytes used in it
+		size_t _current;
+		size_t _used;
+//		bytes handed out since the last reset, rewound tails are subtracted
+		size_t _allocated;
+//		allocations too big for a block, freed by Reset
+		std::vector<char *> _oversized;
+		ArenaStats _stats;
+};
+
+// standard allocator drawing from an arena, containers using it must not outlive the iteration
+template <typename T>
+class ArenaAllocator {
+	public:
+		typedef T value_type;
+
+		ArenaAllocator(Arena &arena) : _arena(&arena) {}
+		template <typename U>
+		ArenaAllocator(const ArenaAllocator<U> &other) : _arena(other.GetArena()) {}
+
+		T* allocate(size_t count) {
+			return static_cast<T *>(_arena->Allocate(count * sizeof(T), alignof(T)));
+		}
+		void deallocate(T *ptr, size_t count) {
+			_arena->Deallocate(ptr, count * sizeof(T));
+		}
+		Arena* GetArena() const {
+			return _arena;
+		}
+
+	private:
+		Arena *_arena;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b) {
+	return a.GetArena() == b.GetArena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b) {
+	return a.GetArena() != b.GetArena();
+}
+
+// command scoped string & vector, constructed from the server's arena
+typedef std::basic_string<char, std::char_traits<char>, ArenaAllocator<char> > ArenaString;
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T> >;
+
+#endif //IRC_ARENA_H
@@ -0,0 +1,51 @@
+//
+// Created on 10/18/26.
+//
+
+#ifndef IRC_BUFFERPOOL_H
+#define IRC_BUFFERPOOL_H
+
+#include <cstddef>
+#include <vector>
+
+// size of a pooled receive buffer, holds a few partial lines plus one recv
+#define RECV_SLAB_SIZE 2048
+// slabs allocated at once when the pool runs dry
+#define RECV_SLABS_PER_BLOCK 64
+
+// occupancy of a buffer pool
+struct BufferPoolStats {
+	size_t slabs;
+	size_t slabsInUse;
+	size_t oversizedInUse;
+	size_t oversizedBytes;
+};
+
+// fixed size slabs carved out of large blocks, free slabs are chained through their first bytes
+class BufferPool {
+	public:
+		BufferPool();
+		~BufferPool();
+
+		char* Acquire();
+		void Release(char *slab);
+		size_t GetSlabSize() const;
+
+//		bookkeeping of buffers that outgrew a slab & live on the heap
+		void CountOversized(size_t bytes);
+		void UncountOversized(size_t bytes);
+
+		const BufferPoolStats& GetStats() const;
+
+	private:
+		BufferPool(const BufferPool &);
+		BufferPool& operator=(const BufferPool &);
+
+		void _grow();
+
+		std::vector<char *> _blocks;
+		char *_free;
+		BufferPoolStats _stats;
+};
+
+#endif //IRC_BUFFERPOOL_H
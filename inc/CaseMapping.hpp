@@ -0,0 +1,38 @@
+//
+// Created on 10/18/26.
+//
+
+#ifndef IRC_CASEMAPPING_H
+#define IRC_CASEMAPPING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// RFC 1459 casemapping, A-Z, [, \, ] & ^ are the upper case of a-z, {, |, } & ~
+class CaseMapping {
+	public:
+//		returns the lower case of a character
+		static char Fold(char c) {
+			return (c >= 'A' && c <= '^') ? static_cast<char>(c + ('a' - 'A')) : c;
+		}
+		static bool Equals(std::string_view a, std::string_view b);
+//		returns a hash of the folded name, names that are Equals hash alike
+		static size_t Hash(std::string_view name);
+};
+
+// hash & equality of unordered containers keyed by nicknames or channel names
+struct CaseFoldHash {
+	size_t operator()(const std::string &name) const {
+		return CaseMapping::Hash(name);
+	}
+};
+
+struct CaseFoldEqual {
+	bool operator()(const std::string &a, const std::string &b) const {
+		return CaseMapping::Equals(a, b);
+	}
+};
+
+#endif //IRC_CASEMAPPING_H
@@ -10,20 +10,22 @@
 #include <algorithm>
 #include "Enums.hpp"
 #include "Client.hpp"
+#include "ChannelMembers.hpp"
+#include "ChannelHistory.hpp"
 
 class Channel {
 	public:
 		Channel();
 		~Channel();
 
-		std::string GetName() const;
-		std::string GetTopic() const;
+		const std::string& GetName() const;
+		const std::string& GetTopic() const;
 		bool GetInviteOnly() const;
 		size_t GetUserLimit() const;
-		std::vector<std::string>& GetMessages();
-		std::vector<int>& GetOperators();
-		std::vector<int>& GetUsers();
-		std::vector<int>& GetInvited();
+		ChannelHistory& GetHistory();
+		const ChannelHistory& GetHistory() const;
+		const ChannelMembers& GetMembers() const;
+		size_t GetUserCount() const;
 		std::string GetPassword() const; // (from channel.cpp)
 
 		void SetName(std::string name);
@@ -39,18 +41,22 @@ class Channel {
 		bool GetTopicOnlySettableByOperator() const;
 
 
-		void AddUser(int user);
-		void MakeOperator(int user);
+		void AddUser(const ClientHandle &user);
+		void MakeOperator(const ClientHandle &user);
 		void RemoveOperator(int user);
 		void RemoveUser(int user);
-		bool IsUserOperator(int user);
+		bool IsUser(const ClientHandle &user) const;
+		bool IsUserOperator(const ClientHandle &user) const;
+		void Invite(const ClientHandle &user);
+		bool IsInvited(const ClientHandle &user) const;
 
 	private:
 		std::string _name;
 		std::string _password;
 		bool _inviteOnly;
 		size_t _userLimit;
-		std::vector<std::string> _messages;
+//		recent PRIVMSG lines for CHATHISTORY
+		ChannelHistory _history;
 		
 		
 		std::string _topic;          // Text content of the topic
@@ -58,10 +64,8 @@ class Channel {
 		bool _topicOnlySettableByOperator; // Whether only operators can set the topic
     	time_t _topicSetTime;        // When the topic was set
 
-//		use the fd of the client instead of the client itself
-		std::vector<int> _operators;
-		std::vector<int> _users;
-		std::vector<int> _invited;
+//		use the fd of the client instead of the client itself, joined, operator & invited in one table
+		ChannelMembers _members;
 };
 
 
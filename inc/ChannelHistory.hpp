@@ -0,0 +1,72 @@
+//
+// Created on 10/18/26.
+//
+
+#ifndef IRC_CHANNELHISTORY_H
+#define IRC_CHANNELHISTORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// length of a timestamp in the IRCv3 server-time format, 2026-10-18T12:00:00.000Z
+#define HISTORY_TIME_SIZE 24
+
+// a stored line, its bytes are a contiguous run of the byte ring
+struct HistoryEntry {
+	uint64_t msgid;
+//	wall clock time in milliseconds since the epoch
+	int64_t timeMs;
+	uint32_t offset;
+	uint32_t size;
+};
+
+// recent lines of a channel in a byte budget, the oldest are evicted to make room
+// the lines are packed back to back into one ring of bytes, a line that would wrap starts over at offset 0
+// the entries are a second ring in arrival order, so paging never allocates & a lookup is a scan of 24 byte records
+class ChannelHistory {
+	public:
+		static const size_t npos = static_cast<size_t>(-1);
+
+		ChannelHistory();
+		~ChannelHistory();
+
+//		sets the byte budget, 0 disables the history & drops what is stored
+		void SetBudget(size_t bytes);
+//		stores a line, evicting the oldest ones until it fits, lines above the budget are not stored
+		void Append(uint64_t msgid, int64_t timeMs, std::string_view line);
+
+//		entries are indexed from the oldest (0) to the latest (size() - 1)
+		size_t size() const;
+		const HistoryEntry& At(size_t index) const;
+		std::string_view GetLine(const HistoryEntry &entry) const;
+//		index of a msgid, npos if it was evicted or never stored
+		size_t Find(uint64_t msgid) const;
+//		index of the first entry not older than timeMs, size() if there is none
+		size_t FindTime(int64_t timeMs) const;
+		size_t GetUsedBytes() const;
+
+//		server-time formatting of the CHATHISTORY batches, out has room for HISTORY_TIME_SIZE bytes
+		static void FormatTime(int64_t timeMs, char *out);
+		static bool ParseTime(std::string_view text, int64_t &timeMs);
+
+	private:
+		void _makeRoom(size_t size);
+		void _popOldest();
+		void _growBytes(size_t size);
+		void _growEntries();
+
+		size_t _budget;
+//		byte ring, grows by doubling up to the budget
+		std::vector<char> _bytes;
+//		offset the next line is written at
+		size_t _head;
+		size_t _usedBytes;
+//		entry ring, _first is the oldest
+		std::vector<HistoryEntry> _entries;
+		size_t _first;
+		size_t _count;
+};
+
+#endif //IRC_CHANNELHISTORY_H
@@ -0,0 +1,58 @@
+//
+// Created on 10/18/26.
+//
+
+#ifndef IRC_CHANNELMEMBERS_H
+#define IRC_CHANNELMEMBERS_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Enums.hpp"
+#include "Client.hpp"
+
+// slots of the index on the first insert, a power of two
+#define CHANNEL_MEMBERS_INITIAL_SLOTS 8
+
+struct ChannelMember {
+	int fd;
+//	MemberFlag bits
+	unsigned flags;
+//	generation of the client the bits belong to, an entry left behind by a closed client is stale
+	uint32_t generation;
+};
+
+// membership of a channel keyed by client fd, one entry per client holding its MemberFlag bits
+// entries are dense with the joined members first, so fan-out walks a flat array
+// an open addressed index maps an fd to its entry, lookups, inserts & removals are O(1)
+class ChannelMembers {
+	public:
+		ChannelMembers();
+		~ChannelMembers();
+
+		bool Has(const ClientHandle &client, unsigned flag) const;
+		void Set(const ClientHandle &client, unsigned flag);
+		void Clear(int fd, unsigned flag);
+		void Remove(int fd);
+
+//		joined members only
+		const ChannelMember* begin() const;
+		const ChannelMember* end() const;
+		size_t size() const;
+
+	private:
+		size_t _home(int fd) const;
+		size_t _findSlot(int fd) const;
+		void _swapEntries(size_t a, size_t b);
+		void _eraseSlot(size_t slot);
+		void _grow();
+
+//		[0, _joined) are joined members, the rest only carry other bits
+		std::vector<ChannelMember> _entries;
+		size_t _joined;
+//		entry position per slot, -1 when empty, linear probing
+		std::vector<int> _slots;
+		unsigned _shift;
+};
+
+#endif //IRC_CHANNELMEMBERS_H
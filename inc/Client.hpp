@@ -7,33 +7,128 @@
 
 #include <string>
 #include <vector>
+#include <deque>
+#include <unordered_set>
+#include <cstdint>
+#include <sys/uio.h>
 #include "Enums.hpp"
+#include "RecvBuffer.hpp"
+#include "SendBuffer.hpp"
+#include "CaseMapping.hpp"
+
+// queued replies are packed into chunks of this size, one iovec each
+#define SEND_CHUNK_SIZE 4096
+
+// names a client across fd reuse, the generation changes whenever its fd slot is freed
+struct ClientHandle {
+	int fd;
+	uint32_t generation;
+};
+
+// names of the channels a client joined, compared under the RFC 1459 casemapping like the channels themselves
+typedef std::unordered_set<std::string, CaseFoldHash, CaseFoldEqual> JoinedChannels;
 
 class Client {
 	public:
 		Client();
 		Client(int fd);
+		Client(int fd, BufferPool *recvPool);
 		~Client();
 
-		std::string GetUserName() const;
-		std::string GetNickName() const;
+		const std::string& GetUserName() const;
+		const std::string& GetNickName() const;
 		bool GetAuthenticated() const;
-		std::string GetMsgBuffer();
 		int GetFd() const;
+		uint32_t GetAddress() const;
 
-		void SetMsgBuffer(std::string msgBuffer);
 		void SetUserName(std::string userName);
 		void SetNickName(std::string nickName);
 		void SetAuthenticated(bool authenticated);
+		void SetAddress(uint32_t address);
+//		peer address as text & the nick!user@host source of the client's messages, rebuilt by the setters
+		const std::string& GetHost() const;
+		const std::string& GetPrefix() const;
+
+//		bytes received but not yet split into complete lines
+		RecvBuffer& GetRecvBuffer();
+
+//		outbound queue, flushed by the server once per loop iteration or when writable
+		void QueueMessage(std::string_view msg);
+//		returns room for a size byte line at the end of the queue, the caller fills all of it
+		char* ReserveMessage(size_t size);
+//		queues a reference to an encoded line, the bytes are shared with the other recipients
+		void QueueBuffer(const SendBuffer &buffer);
+		bool HasPendingOutput() const;
+		size_t GetPendingSize() const;
+		int GetPendingIovecs(struct iovec *iov, int maxIov) const;
+		void ConsumePending(size_t bytes);
+		std::deque<SendBuffer> TakeSendQueue();
+		bool GetWriteArmed() const;
+		void SetWriteArmed(bool writeArmed);
+		bool GetFlushScheduled() const;
+		void SetFlushScheduled(bool flushScheduled);
+
+//		registration & keepalive state, times are monotonic milliseconds
+		bool GetRegistered() const;
+		void SetRegistered(bool registered);
+		uint64_t GetLastActivity() const;
+		void SetLastActivity(uint64_t lastActivity);
+		uint64_t GetPingSentAt() const;
+		void SetPingSentAt(uint64_t pingSentAt);
+		int64_t GetRtt() const;
+		void SetRtt(int64_t rtt);
+
+//		slow consumer bookkeeping
+		bool GetSendqExceeded() const;
+		void SetSendqExceeded(bool sendqExceeded);
+		size_t GetDroppedMessages() const;
+		void CountDroppedMessage();
+
+//		channels the client is a member of, kept in sync with the member lists by the server
+		const JoinedChannels& GetChannels() const;
+		bool IsInChannel(const std::string &channelName) const;
+		void AddChannel(const std::string &channelName);
+		void RemoveChannel(const std::string &channelName);
 
 	private:
+		void _renderPrefix();
+
 		int _fd;
 		std::string _userName;
 		std::string _nickName;
 		bool _authenticated;
+//		peer IPv4 address in network byte order
+		uint32_t _address;
+		std::string _host;
+//		rendered once per NICK, USER or address change instead of once per message
+		std::string _prefix;
+
+//		holds received bytes up to the last complete line
+		RecvBuffer _recvBuffer;
 
-//		holds chunked message
-		std::string _msgBuffer;
+//		holds queued outbound chunks, everything before _sendOffset in the front chunk is already sent
+//		a chunk is either private to the client or a broadcast line shared with other queues
+		std::deque<SendBuffer> _sendQueue;
+		size_t _sendOffset;
+		size_t _pendingBytes;
+//		whether the poller currently waits for the socket to become writable
+		bool _writeArmed;
+//		whether the client is on the server's flush list for this loop iteration
+		bool _flushScheduled;
+//		whether PASS, NICK & USER completed
+		bool _registered;
+//		last time a line was received
+		uint64_t _lastActivity;
+//		when the unanswered keepalive PING was sent, 0 if none is outstanding
+		uint64_t _pingSentAt;
+//		round trip time of the last answered keepalive PING, -1 until one was answered
+		int64_t _rtt;
+//		whether the client hit the sendq limit & is closed at the end of the loop iteration
+		bool _sendqExceeded;
+//		low priority lines dropped because the sendq was above its high-water mark
+		size_t _droppedMessages;
+//		names of the joined channels, QUIT & NICK only visit these
+		JoinedChannels _channels;
 };
 
 
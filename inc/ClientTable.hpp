@@ -0,0 +1,54 @@
+//
+// Created on 10/18/26.
+//
+
+#ifndef IRC_CLIENTTABLE_H
+#define IRC_CLIENTTABLE_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Client.hpp"
+
+// clients indexed by fd, a lookup is a single indexed load
+// every slot carries a generation bumped when its client leaves, so a ClientHandle kept past the
+// client's lifetime is recognized as stale once the fd is reused
+// growing the table moves the clients, references are only stable until the next Insert
+class ClientTable {
+	public:
+		ClientTable();
+		~ClientTable();
+
+//		returns the client on fd, the fd must be live (see Contains)
+		Client& operator[](int fd) {
+			return _slots[fd].client;
+		}
+//		returns the client on fd, nullptr if there is none
+		Client* Find(int fd) {
+			return Contains(fd) ? &_slots[fd].client : nullptr;
+		}
+		bool Contains(int fd) const {
+			return fd >= 0 && static_cast<size_t>(fd) < _slots.size() && _slots[fd].livePos != -1;
+		}
+
+		Client& Insert(int fd, const Client &client);
+		void Erase(int fd);
+		size_t size() const;
+//		live fds in no particular order, invalidated by Insert & Erase
+		const std::vector<int>& GetFds() const;
+
+		ClientHandle GetHandle(int fd) const;
+
+	private:
+		struct Slot {
+			Client client;
+			uint32_t generation;
+//			position in _live, -1 while the slot is free
+			int livePos;
+		};
+
+		std::vector<Slot> _slots;
+		std::vector<int> _live;
+};
+
+#endif //IRC_CLIENTTABLE_H
@@ -23,10 +23,29 @@ enum Method {
 	TOPIC,
 	MODE,
 	PING,
+	PONG,
 	QUIT,
+	STATS,
+	CHATHISTORY,
 	INVALID,
 };
 
+enum ParseResult {
+	PARSE_OK,
+//	blank line, silently ignored
+	PARSE_EMPTY,
+//	longer than MAX_LINE_LENGTH
+	PARSE_TOO_LONG,
+};
+
+enum LineStatus {
+//	no complete line is buffered
+	LINE_NONE,
+	LINE_OK,
+//	more than MAX_LINE_SIZE bytes without a terminator, they were discarded
+	LINE_TOO_LONG,
+};
+
 enum Mode {
 	MAKE_INVITE_ONLY, // +i
 	UNMAKE_INVITE_ONLY, // -i
@@ -41,4 +60,116 @@ enum Mode {
 	INVALID_MODE,
 };
 
+enum ShardMessageType {
+//	deliver a line to the local members of a channel
+	SHARD_CHANNEL_LINE,
+//	deliver a line to a local client by nickname
+	SHARD_USER_LINE,
+//	update the topic of the local channel & deliver the line to its members
+	SHARD_CHANNEL_TOPIC,
+//	remove a local client from a channel & deliver the kick line
+	SHARD_CHANNEL_KICK,
+//	add a local client to the invite list of a channel & deliver the invite line
+	SHARD_CHANNEL_INVITE,
+//	deliver a line once to the local members of several channels (NICK, QUIT)
+	SHARD_CHANNELS_LINE,
+//	give or take the operator status of a local member
+	SHARD_CHANNEL_OPERATOR,
+};
+
+// outcome of a JOIN checked against the state of a channel
+enum JoinResult {
+//	the channel did not exist, the client becomes its operator
+	JOIN_CREATED,
+	JOIN_OK,
+//	+l & the limit is reached
+	JOIN_FULL,
+//	+i & the client was not invited
+	JOIN_INVITE_ONLY,
+//	+k & the key does not match
+	JOIN_BAD_KEY,
+};
+
+enum AdmissionResult {
+	ADMISSION_OK,
+//	server is full
+	ADMISSION_MAX_CLIENTS,
+//	too many open connections from the same address
+	ADMISSION_PER_IP_LIMIT,
+//	too many new connections from the same address within the rate window
+	ADMISSION_RATE_LIMIT,
+};
+
+// how far a queued line may be pushed back when the recipient stops reading
+enum SendPriority {
+//	replies & state changes, always queued until the hard sendq limit
+	SEND_NORMAL,
+//	channel chatter, dropped once the sendq is above its high-water mark
+	SEND_LOW,
+};
+
+enum PollerBackend {
+	POLLER_EPOLL,
+	POLLER_POLL,
+	POLLER_URING,
+};
+
+// kind of io_uring request, encoded into the request's user data
+enum UringOperation {
+//	probes & cancellations nobody waits for
+	URING_OP_INTERNAL,
+	URING_OP_ACCEPT,
+	URING_OP_RECV,
+	URING_OP_SEND,
+	URING_OP_WAKE,
+};
+
+// per member bits of a channel, an entry is dropped once none is set
+enum MemberFlag {
+	MEMBER_JOINED = 1 << 0,
+	MEMBER_OPERATOR = 1 << 1,
+//	reserved for +v
+	MEMBER_VOICE = 1 << 2,
+//	may join while the channel is +i, consumed by the join
+	MEMBER_INVITED = 1 << 3,
+	MEMBER_ALL = MEMBER_JOINED | MEMBER_OPERATOR | MEMBER_VOICE | MEMBER_INVITED,
+};
+
+// numeric replies, the value is the code sent on the wire
+enum Numeric {
+	RPL_WELCOME = 1,
+	RPL_STATSLINKINFO = 211,
+	RPL_ENDOFSTATS = 219,
+	RPL_STATSDEBUG = 249,
+	RPL_NOTOPIC = 331,
+	RPL_TOPIC = 332,
+	RPL_TOPICWHOTIME = 333,
+	RPL_INVITING = 341,
+	RPL_NAMREPLY = 353,
+	RPL_ENDOFNAMES = 366,
+	ERR_UNKNOWNERROR = 400,
+	ERR_NOSUCHNICK = 401,
+	ERR_NOSUCHCHANNEL = 403,
+	ERR_NOORIGIN = 409,
+	ERR_NOTEXTTOSEND = 412,
+	ERR_INPUTTOOLONG = 417,
+	ERR_UNKNOWNCOMMAND = 421,
+	ERR_ERRONEUSNICKNAME = 432,
+	ERR_NICKNAMEINUSE = 433,
+	ERR_USERNOTINCHANNEL = 441,
+	ERR_NOTONCHANNEL = 442,
+	ERR_USERONCHANNEL = 443,
+	ERR_NOTREGISTERED = 451,
+	ERR_NEEDMOREPARAMS = 461,
+	ERR_PASSWDMISMATCH = 464,
+	ERR_CHANNELISFULL = 471,
+	ERR_UNKNOWNMODE = 472,
+	ERR_INVITEONLYCHAN = 473,
+	ERR_BADCHANNELKEY = 475,
+	ERR_NOPRIVILEGES = 481,
+	ERR_CHANOPRIVSNEEDED = 482,
+//	one past the highest possible code
+	NUMERIC_LIMIT = 1000,
+};
+
 #endif //IRC_ENUMS_H
@@ -0,0 +1,35 @@
+//
+// Created on 10/18/26.
+//
+
+#ifndef IRC_EPOLLPOLLER_H
+#define IRC_EPOLLPOLLER_H
+
+#include <vector>
+#include "Poller.hpp"
+
+#ifdef __linux__
+# include <sys/epoll.h>
+
+// epoll(7) backend, per wakeup cost is O(ready fds)
+class EpollPoller : public Poller {
+	public:
+		EpollPoller();
+		~EpollPoller();
+
+		bool Add(int fd, uint32_t events, bool edgeTriggered);
+		bool Modify(int fd, uint32_t events);
+		void Remove(int fd);
+		int Wait(std::vector<PollerEvent>& events, int timeoutMs);
+		const char* GetName() const;
+
+	private:
+		int _epollFd;
+		std::vector<epoll_event> _epollEvents;
+//		remembers which fds were registered edge triggered
+		std::vector<bool> _edgeTriggered;
+};
+
+#endif //__linux__
+
+#endif //IRC_EPOLLPOLLER_H
@@ -0,0 +1,122 @@
+//
+// Created on 10/18/26.
+//
+
+#ifndef IRC_IOURING_H
+#define IRC_IOURING_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+# define IRC_HAS_IO_URING 1
+# include <linux/io_uring.h>
+
+// provided receive buffers shared by all multishot recvs of one ring
+#define URING_QUEUE_DEPTH 1024
+#define URING_BUFFER_COUNT 512
+#define URING_BUFFER_SIZE 2048
+#define URING_BUFFER_GROUP 0
+
+struct IoCompletion {
+	uint64_t userData;
+	int32_t res;
+	uint32_t flags;
+};
+
+// thin io_uring wrapper without liburing, owns the rings & the provided buffer ring
+class IoUring {
+	public:
+		IoUring();
+		~IoUring();
+
+//		request preparation, nothing reaches the kernel before the next submit
+		void PrepareMultishotAccept(int fd, uint64_t userData);
+		void PrepareMultishotRecv(int fd, uint64_t userData);
+		void PrepareMultishotPoll(int fd, uint64_t userData);
+		void PrepareSend(int fd, const void *data, size_t size, bool linkNext, uint64_t userData);
+		void ReserveSubmissions(unsigned count);
+
+//		cancels every request on a fd right away, must happen before the fd is closed
+		void CancelFd(int fd, uint64_t userData);
+
+//		submits prepared requests & waits for at least one completion, -1 on error
+		int SubmitAndWait(std::vector<IoCompletion> &completions, int timeoutMs);
+
+//		provided buffers handed out by multishot recv
+		const char* GetBuffer(uint16_t bufferId) const;
+		void RecycleBuffer(uint16_t bufferId);
+
+//		completion flag helpers
+		static bool HasMore(uint32_t flags);
+		static bool HasBuffer(uint32_t flags, uint16_t &bufferId);
+
+	private:
+		IoUring(const IoUring &);
+		IoUring& operator=(const IoUring &);
+
+		struct io_uring_sqe* _getSqe();
+		int _enter(unsigned toSubmit, unsigned minComplete, unsigned flags, void *arg, size_t argSize);
+		void _setupBufferRing();
+		void _probeMultishotRecv();
+		void _release();
+
+		int _ringFd;
+
+//		submission & completion rings share one mapping
+		void *_ringMemory;
+		size_t _ringMemorySize;
+		struct io_uring_sqe *_sqes;
+		size_t _sqesSize;
+
+//		submission queue
+		unsigned *_sqHead;
+		unsigned *_sqTail;
+		unsigned *_sqArray;
+		unsigned _sqMask;
+		unsigned _sqEntries;
+		unsigned _sqLocalTail;
+
+//		completion queue
+		unsigned *_cqHead;
+		unsigned *_cqTail;
+		unsigned _cqMask;
+		struct io_uring_cqe *_cqes;
+
+//		provided buffer ring
+		struct io_uring_buf_ring *_bufRing;
+		size_t _bufRingSize;
+		char *_buffers;
+		unsigned _bufTail;
+};
+
+#else
+
+struct IoCompletion {
+	uint64_t userData;
+	int32_t res;
+	uint32_t flags;
+};
+
+// io_uring is Linux only, constructing it always fails so the server falls back to a poller
+class IoUring {
+	public:
+		IoUring();
+
+		void PrepareMultishotAccept(int fd, uint64_t userData);
+		void PrepareMultishotRecv(int fd, uint64_t userData);
+		void PrepareMultishotPoll(int fd, uint64_t userData);
+		void PrepareSend(int fd, const void *data, size_t size, bool linkNext, uint64_t userData);
+		void ReserveSubmissions(unsigned count);
+		void CancelFd(int fd, uint64_t userData);
+		int SubmitAndWait(std::vector<IoCompletion> &completions, int timeoutMs);
+		const char* GetBuffer(uint16_t bufferId) const;
+		void RecycleBuffer(uint16_t bufferId);
+		static bool HasMore(uint32_t flags);
+		static bool HasBuffer(uint32_t flags, uint16_t &bufferId);
+};
+
+#endif
+
+#endif //IRC_IOURING_H
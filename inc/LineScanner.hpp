@@ -0,0 +1,27 @@
+//
+// Created on 10/18/26.
+//
+
+#ifndef IRC_LINESCANNER_H
+#define IRC_LINESCANNER_H
+
+#include <cstddef>
+
+// longest line without its CRLF, RFC 1459 allows 512 bytes including it
+#define MAX_LINE_LENGTH 510
+// longest input kept while waiting for a terminator, a full line plus CRLF
+#define MAX_LINE_SIZE (MAX_LINE_LENGTH + 2)
+
+// finds line terminators in received bytes, both CRLF & a bare LF end a line
+// the search compares 32 (AVX2) or 16 (SSE2) bytes at a time, the variant is picked once at startup
+class LineScanner {
+	public:
+//		returns the offset of the first LF in data, npos if there is none
+		static size_t FindLineFeed(const char *data, size_t size);
+//		returns the length of the line terminated by the LF at offset lf, without a trailing CR
+		static size_t GetLineLength(const char *data, size_t lf);
+//		returns the name of the variant in use
+		static const char* GetVariant();
+};
+
+#endif //IRC_LINESCANNER_H
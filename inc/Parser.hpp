@@ -6,21 +6,33 @@
 #define IRC_PARSER_H
 
 #include <string>
-#include <vector>
-#include "Client.hpp"
+#include <string_view>
+#include <cstddef>
 #include "Enums.hpp"
-#include <tuple>
-#include <algorithm>
-#include <sstream>
+#include "LineScanner.hpp"
 
+// parameters of a message, the 15th takes the rest of the line
+#define MAX_PARAMS 15
+
+// one parsed line, every view points into the line that was parsed
+struct MessageView {
+	Method method;
+	std::string_view prefix;
+	std::string_view command;
+	std::string_view params[MAX_PARAMS];
+	size_t paramCount;
+};
+
+// splits a line into prefix, command & parameters (RFC 1459/2812 grammar) without allocating
 class Parser {
 	public:
 		Parser();
 		~Parser();
 
-		std::tuple<Method, std::vector<std::string>> parse(const std::string& msg) const;
+		ParseResult Parse(std::string_view line, MessageView &msg) const;
 
 	private:
+		static Method _lookupMethod(std::string_view command);
 };
 
 
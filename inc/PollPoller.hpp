@@ -0,0 +1,30 @@
+//
+// Created on 10/18/26.
+//
+
+#ifndef IRC_POLLPOLLER_H
+#define IRC_POLLPOLLER_H
+
+#include <poll.h>
+#include <vector>
+#include "Poller.hpp"
+
+// portable poll(2) backend, O(n) per wakeup but O(1) registration & removal
+class PollPoller : public Poller {
+	public:
+		PollPoller();
+		~PollPoller();
+
+		bool Add(int fd, uint32_t events, bool edgeTriggered);
+		bool Modify(int fd, uint32_t events);
+		void Remove(int fd);
+		int Wait(std::vector<PollerEvent>& events, int timeoutMs);
+		const char* GetName() const;
+
+	private:
+		std::vector<pollfd> _pollFds;
+//		maps fd to its slot in _pollFds, -1 if not registered
+		std::vector<int> _slots;
+};
+
+#endif //IRC_POLLPOLLER_H
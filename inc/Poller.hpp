@@ -0,0 +1,44 @@
+//
+// Created on 10/18/26.
+//
+
+#ifndef IRC_POLLER_H
+#define IRC_POLLER_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Enums.hpp"
+
+// readiness flags reported by & requested from a poller backend
+#define POLLER_READ 0x1
+#define POLLER_WRITE 0x2
+#define POLLER_CLOSE 0x4
+
+#define MAX_POLLER_EVENTS 1024
+
+struct PollerEvent {
+	int fd;
+	uint32_t events;
+};
+
+// readiness backend used by the server's event loop
+class Poller {
+	public:
+		virtual ~Poller();
+
+//		registers, updates & unregisters a file descriptor
+		virtual bool Add(int fd, uint32_t events, bool edgeTriggered) = 0;
+		virtual bool Modify(int fd, uint32_t events) = 0;
+		virtual void Remove(int fd) = 0;
+
+//		waits for readiness & fills events with the ready fds only, returns -1 on error
+		virtual int Wait(std::vector<PollerEvent>& events, int timeoutMs) = 0;
+
+		virtual const char* GetName() const = 0;
+
+//		creates the requested backend, falls back to poll if it is unavailable
+		static Poller* Create(PollerBackend backend);
+};
+
+#endif //IRC_POLLER_H
@@ -0,0 +1,61 @@
+//
+// Created on 10/18/26.
+//
+
+#ifndef IRC_RECVBUFFER_H
+#define IRC_RECVBUFFER_H
+
+#include <cstddef>
+#include <string_view>
+#include "BufferPool.hpp"
+#include "LineScanner.hpp"
+#include "Enums.hpp"
+
+// capacity of a receive buffer on its first use, doubled whenever a line does not fit
+#define RECV_BUFFER_INITIAL_SIZE 2048
+
+// growable receive buffer, recv writes at the write cursor & lines are consumed at the read cursor
+// storage is leased from a pool & only held while a partial line is pending
+class RecvBuffer {
+	public:
+		RecvBuffer();
+		explicit RecvBuffer(BufferPool *pool);
+		RecvBuffer(const RecvBuffer &other);
+		RecvBuffer(RecvBuffer &&other) noexcept;
+		RecvBuffer& operator=(RecvBuffer other) noexcept;
+		~RecvBuffer();
+
+//		returns room for at least minSpace bytes at the write cursor, compacts or grows if needed
+		char* Reserve(size_t minSpace);
+		size_t GetWritableSize() const;
+		void Commit(size_t bytes);
+		void Append(const char *data, size_t size);
+
+//		pops the next CRLF or LF terminated line, the view stays valid until the next Reserve/Append
+		LineStatus NextLine(std::string_view &line);
+		bool Empty() const;
+//		returns if input is dropped until the end of an overlong line
+		bool IsDiscarding() const;
+		size_t GetSize() const;
+//		hands the storage back once every received line was consumed
+		void ReleaseIfEmpty();
+
+	private:
+		void _swap(RecvBuffer &other) noexcept;
+		char* _allocate(size_t capacity);
+		void _deallocate();
+		void _consume(size_t end);
+
+//		nullptr allocates from the heap
+		BufferPool *_pool;
+		char *_data;
+		size_t _capacity;
+//		unread bytes live in [_readPos, _writePos), bytes before _scanPos hold no LF
+		size_t _readPos;
+		size_t _writePos;
+		size_t _scanPos;
+//		set after an overlong line, input is dropped up to its terminator
+		bool _discarding;
+};
+
+#endif //IRC_RECVBUFFER_H
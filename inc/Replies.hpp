@@ -0,0 +1,51 @@
+//
+// Created on 10/18/26.
+//
+
+#ifndef IRC_REPLIES_H
+#define IRC_REPLIES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <initializer_list>
+#include "Enums.hpp"
+
+// numeric replies rendered from templates that are compiled once at startup
+// a template is a list of literal runs & parameter slots, the server name & the code are part of its first run
+// rendering measures the parameters first, then writes the whole line in one pass into memory of the caller
+class Replies {
+	public:
+		explicit Replies(const std::string &serverName);
+		~Replies();
+
+//		returns the size of the line including its CRLF, 0 for a numeric without template
+		size_t Measure(Numeric numeric, std::string_view target, std::initializer_list<std::string_view> params) const;
+//		writes the line into out, which has room for Measure bytes
+		void Render(Numeric numeric, std::string_view target, std::initializer_list<std::string_view> params,
+			char *out) const;
+		const std::string& GetServerName() const;
+
+	private:
+//		a literal run of _literals, or the parameter in slot when slot is not -1
+		struct Segment {
+			uint32_t offset;
+			uint32_t size;
+			int slot;
+		};
+
+		void _compile(Numeric numeric, const char *format);
+		void _addLiteral(std::vector<Segment> &segments, std::string_view text);
+		static std::string_view _slot(int slot, std::string_view target,
+			std::initializer_list<std::string_view> params);
+
+		std::string _serverName;
+//		literal runs of every template
+		std::string _literals;
+//		segments per code, slot 0 is the target & slot n + 1 the nth parameter
+		std::vector<Segment> _templates[NUMERIC_LIMIT];
+};
+
+#endif //IRC_REPLIES_H
@@ -0,0 +1,47 @@
+//
+// Created on 10/18/26.
+//
+
+#ifndef IRC_SENDBUFFER_H
+#define IRC_SENDBUFFER_H
+
+#include <cstddef>
+#include <string_view>
+
+// reference counted block of outbound bytes, copies share the block instead of the bytes
+// a broadcast line is encoded into one block & every recipient queues a reference to it
+// bytes can only be appended while a single reference exists, what a queue handed out never changes
+// the count is not atomic, a block never leaves the shard that created it
+class SendBuffer {
+	public:
+		SendBuffer();
+//		copies data into a new block with room for at least capacity bytes
+		explicit SendBuffer(std::string_view data, size_t capacity = 0);
+		SendBuffer(const SendBuffer &other);
+		SendBuffer(SendBuffer &&other) noexcept;
+		SendBuffer& operator=(SendBuffer other) noexcept;
+		~SendBuffer();
+
+		const char* GetData() const;
+		size_t GetSize() const;
+//		returns how many bytes Append accepts, 0 while the block is shared
+		size_t GetSpace() const;
+		void Append(std::string_view data);
+//		grows the block by size bytes & returns them for the caller to fill, the caller checks GetSpace first
+		char* Extend(size_t size);
+
+	private:
+		struct Block {
+			size_t refs;
+			size_t size;
+			size_t capacity;
+		};
+
+		char* _bytes() const;
+		void _release();
+
+//		header followed by capacity bytes in the same allocation, nullptr when empty
+		Block *_block;
+};
+
+#endif //IRC_SENDBUFFER_H
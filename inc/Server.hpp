@@ -7,7 +7,6 @@
 
 #include <sys/socket.h>
 #include <string>
-#include <poll.h>
 #include <netdb.h>
 #include <cstring>
 #include <iostream>
@@ -16,22 +15,74 @@
 #include <stdexcept>
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <initializer_list>
+#include <string_view>
+#include <memory>
+#include <cerrno>
+#include <ctime>
 #include <algorithm>
+#include <sstream>
 #include "Client.hpp"
+#include "ClientTable.hpp"
 #include "Channel.hpp"
 #include "Parser.hpp"
 #include "Enums.hpp"
+#include "Poller.hpp"
+#include "IoUring.hpp"
+#include "ServerConfig.hpp"
+#include "ShardBus.hpp"
+#include "Admission.hpp"
+#include "TimerWheel.hpp"
+#include "CaseMapping.hpp"
+#include "Arena.hpp"
+#include "Replies.hpp"
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
 #include <csignal>
 
 #define MAX_BUFFER_SIZE 1024
 #define MAX_CONNECTIONS SOMAXCONN
 #define NO_USER_LIMIT 0
+// chunks handed to a single writev call
+#define MAX_FLUSH_IOV 64
+// nicknames per RPL_NAMREPLY line in bytes, leaves room for the prefix within 512
+#define NAMES_LINE_SIZE 400
+// slow consumer counters, never reset
+struct SendqStats {
+	size_t evicted;
+	size_t droppedMessages;
+};
+
+// connections accepted per listening socket wakeup, the rest is picked up next iteration
+#define MAX_ACCEPTS_PER_WAKEUP 1024
+// pause of the io_uring accept when fds ran out & no pending connection could be refused
+#define URING_ACCEPT_BACKOFF_MS 100
+// fds kept free for the listening socket, files & the spare fd when deriving max clients
+#define RESERVED_FDS 32
+
+// io_uring bookkeeping per fd, the generation tells completions of a closed client apart
+struct UringSlot {
+	uint32_t generation;
+	uint32_t sendsInFlight;
+};
+
+// outbound chunks of a closed client that in flight sends still point into
+struct RetiredSends {
+	uint32_t sendsInFlight;
+	std::deque<SendBuffer> chunks;
+};
 
 #define INVITED_MSG(channel, user) "You have been invited to channel " + channel + "\r\n"
 
 class Server {
 	public:
-		Server(uint16_t port, std::string password);
+//		signature of every command handler
+		typedef void (Server::*CommandHandler)(int, const std::vector<std::string>&);
+
+		Server(uint16_t port, std::string password, const ServerConfig &config = ServerConfig(),
+			ShardBus *bus = nullptr, size_t shardId = 0);
 		~Server();
 
 //		runs the server
@@ -42,8 +93,17 @@ class Server {
 		void HandleConnection(int clientSocket);
 		void HandleDisconnection(int clientSocket);
 		void Ping(int clientFd, const std::vector<std::string>& tokens);
+		void Pong(int clientFd, const std::vector<std::string>& tokens);
 		void RemoveClient(int clientFd);
 		bool HandleClient(int clientFd);
+		bool FlushClient(int clientFd);
+
+//		io_uring event loop
+		bool RunUring();
+		void HandleUringCompletion(const IoCompletion &completion);
+
+//		cross shard delivery
+		void HandleShardMessages();
 
 //		verification methods
 		void Authenticate(int clientSocket, const std::vector<std::string>& tokens);
@@ -57,6 +117,8 @@ class Server {
 		void Join(int clientSocket, const std::vector<std::string>& tokens);
 		void PrivMsg(int clientSocket, const std::vector<std::string>& tokens);
 		void Quit(int clientSocket, const std::vector<std::string>& /*tokens*/);
+		void Stats(int clientSocket, const std::vector<std::string>& tokens);
+		void ChatHistory(int clientSocket, const std::vector<std::string>& tokens);
 
 //		operator commands for channels
 		void Kick(int clientSocket, const std::vector<std::string>& tokens);
@@ -65,20 +127,76 @@ class Server {
 
 //		operator Mode command & sub commands
 		void Mode(int clientSocket, const std::vector<std::string>& tokens);
-		void _changeInviteOnlyRestriction(std::string channel, bool isInviteOnly);
-		void _changeTopicRestriction(std::string channel, bool isTopicOnlySettableByOperator);
-		void _changePasswordRestriction(std::string channel, std::string password);
-		void _changeOperatorPrivileges(std::string channel, std::string user, bool isOperator);
-		void _changeUserLimitRestriction(std::string channel, size_t userLimit);
-		int _findClientFromNickname(std::string nickname);
-		void _BroadcastToChannel(const std::string &channelName, const std::string &msg);
+		void _changeInviteOnlyRestriction(Channel &channel, bool isInviteOnly);
+		void _changeTopicRestriction(Channel &channel, bool isTopicOnlySettableByOperator);
+		void _changePasswordRestriction(Channel &channel, std::string password);
+		bool _changeOperatorPrivileges(Channel &channel, std::string user, bool isOperator);
+		void _changeUserLimitRestriction(Channel &channel, size_t userLimit);
+		int _findClientFromNickname(const std::string &nickname) const;
+		void _BroadcastToChannel(const Channel &channel, std::string_view msg);
+		std::string_view _userMessage(int clientFd, std::initializer_list<std::string_view> parts);
+		void _reply(int clientFd, Numeric numeric, std::initializer_list<std::string_view> params = {});
+		void _replyTopic(int clientSocket, const Channel &channel);
+		void _replyNames(int clientSocket, const Channel &channel);
+		void _replayHistory(int clientFd, const std::string &subcommand, const Channel &channel,
+			const ChannelHistory &history, std::string_view reference, uint64_t limit);
+		void _failHistory(int clientFd, std::string_view code, std::string_view context, std::string_view description);
+		uint64_t _newMsgid();
+		Channel* _findChannel(const std::string &channelName);
+		void _addChannelMember(Channel &channel, int clientFd);
+		void _removeChannelMember(Channel &channel, int clientFd);
+		void _removeChannelMember(const std::string &channelName, int clientFd);
+		Channel* _admitJoin(int clientFd, const std::string &channelName, std::string_view key);
+		Channel& _localChannel(const ChannelState &state);
+		bool _isTopicRestricted(const Channel &channel) const;
+		void _leaveAllChannels(int clientFd);
+		void _broadcastToPeers(int clientFd, std::string_view msg, int exceptFd);
+		void _sendToClient(int clientFd, std::string_view msg, SendPriority priority = SEND_NORMAL);
+		void _sendToClient(int clientFd, const SendBuffer &buffer, SendPriority priority = SEND_NORMAL);
+		Client* _admitOutput(int clientFd, size_t size, SendPriority priority);
+		void _scheduleFlush(int clientFd, Client &client);
+		void _evictSlowConsumer(int clientFd, Client &client);
+		void _updateClock();
+		void _runTimers();
+		void _handleClientTimer(int clientFd);
+		void _startClientTimer(int clientFd);
+		void _scheduleDisconnect(int clientFd);
+		void _removePendingClients();
+		void _flushPendingOutput();
+		void _settlePending();
+		void _admitClient(int clientFd, const sockaddr_in &clientAddr);
+		void _rejectClient(int clientFd, const sockaddr_in &clientAddr, AdmissionResult reason);
+		bool _refuseWithSpareFd();
+		void _acceptClient(int clientFd, uint32_t address);
+		void _handleInput(int clientSocket, const char *data, size_t size);
+		bool _drainLines(int clientSocket);
+		bool _handleLine(int clientSocket, std::string_view line);
+		void _replyLineTooLong(int clientSocket);
+		void _submitUringSends(int clientFd);
+		void _releaseUringClient(int clientFd);
+		uint64_t _uringUserData(UringOperation op, int fd) const;
+		void _deliverToChannel(const Channel &channel, std::string_view msg, int exceptFd,
+			SendPriority priority = SEND_NORMAL);
+		void _deliverToChannels(const std::vector<std::string> &channelNames, std::string_view msg, int exceptFd,
+			int extraFd = -1);
+		void _relayChannelsLine(const std::vector<std::string> &channelNames, std::string_view line);
+		void _relayChannelLine(const std::string &channelName, std::string_view line,
+			SendPriority priority = SEND_NORMAL);
+		bool _relayUserLine(const std::string &nickname, std::string_view line);
+		bool _relayToNickShard(ShardMessageType type, const std::string &channelName, const std::string &nickname,
+			std::string_view line);
+		void _relayChannelTopic(Channel &channel, std::string_view line);
+		bool _relayChannelOperator(const std::string &channelName, const std::string &nickname, bool isOperator);
+		bool _postToNickShard(const ShardMessage &msg);
 
 //		getters
 		std::string GetHost() const;
 		uint16_t GetPort() const;
 		std::string GetPassword() const;
 		int GetSocket() const;
-		std::vector<pollfd> GetPollFds() const;
+		const char* GetBackendName() const;
+		size_t GetShardId() const;
+		const AdmissionStats& GetAdmissionStats() const;
 
 		static void SignalHandler(int signum);
 		static Server* GetInstance();
@@ -86,27 +204,74 @@ class Server {
 		static void SetInstance(Server* server);
 
 	private:
+//		the microbenchmarks in bench/ drive the private receive & fan-out paths directly
+		friend class ServerBench;
+
 		std::string _host;
 		uint16_t _port;
 		std::string _password;
 		int _socket;
-		std::vector<pollfd> _pollFds;
-//		maps client socket to client
-		std::map<int, Client> _clients;
-//		maps channel name to channel
-		std::map<std::string, Channel> _channels;
-//		mapping of method to function
-		std::map<Method, void (Server::*)(int, const std::vector<std::string>&)> _methods;
+//		readiness backend of the event loop
+		std::unique_ptr<Poller> _poller;
+//		completion backend, replaces the poller when --poller uring is available
+		std::unique_ptr<IoUring> _uring;
+		std::vector<UringSlot> _uringSlots;
+		std::map<uint64_t, RetiredSends> _retiredSends;
+//		monotonic time at which the paused io_uring accept is armed again, 0 while it is armed
+		uint64_t _acceptRetryAt;
+//		clients to disconnect once the current loop iteration is done
+		std::vector<int> _pendingDisconnects;
+//		clients that got output queued during the current loop iteration
+		std::vector<int> _pendingFlushes;
+//		receive buffers of clients with a partial line, declared first so it outlives them
+		BufferPool _recvPool;
+//		maps client socket to client, indexed by fd
+		ClientTable _clients;
+//		nickname to fd of every local client that has one, names compare under the RFC 1459 casemapping
+		std::unordered_map<std::string, int, CaseFoldHash, CaseFoldEqual> _nicknames;
+//		maps channel name to channel, names compare under the RFC 1459 casemapping
+//		nodes never move, a Channel* stays valid for as long as the channel exists
+		typedef std::unordered_map<std::string, Channel, CaseFoldHash, CaseFoldEqual> ChannelMap;
+		ChannelMap _channels;
+//		mapping of method to function, an array indexed by Method
+		CommandHandler _methods[INVALID + 1];
 //		instance of parser class
 		Parser _parser;
+//		parameters of the line being dispatched, reused for every line
+		std::vector<std::string> _params;
+//		temporaries of the commands handled in the current loop iteration, reset at its end
+		Arena _arena;
 		int _listeningFd;
 		static Server* _instance;
 		bool _running;
+//		startup options
+		ServerConfig _config;
+//		numeric reply templates, compiled with the configured server name
+		Replies _replies;
+//		mailboxes of the other shards, nullptr when running single threaded
+		ShardBus *_bus;
+		size_t _shardId;
+		int _wakeFd;
+//		connection limits of this shard
+		Admission _admission;
+		size_t _maxClients;
+//		kept open so a connection can still be accepted & refused once fds run out
+		int _spareFd;
+//		slow consumers evicted & lines dropped for them
+		SendqStats _sendqStats;
+//		keepalive & registration deadlines, one timer per client fd
+		TimerWheel _timers;
+		std::vector<int> _expiredTimers;
+//		monotonic time of the current loop iteration in milliseconds
+		uint64_t _nowMs;
+//		wall clock time of the current loop iteration in milliseconds, stamped on the channel history
+		int64_t _wallMs;
+//		source of msgids, ids of the shards interleave
+		uint64_t _msgidCounter;
+		uint64_t _historyBatches;
 };
 
 Mode _strToModeEnum(std::string str);
-std::string _errMsg(const std::string& nick, const std::string& code, const std::string& msg, const std::string&
-reason);
 
 
 #endif //IRC_SERVER_H
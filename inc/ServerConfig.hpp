@@ -0,0 +1,55 @@
+//
+// Created on 10/18/26.
+//
+
+#ifndef IRC_SERVERCONFIG_H
+#define IRC_SERVERCONFIG_H
+
+#include <cstddef>
+#include <string>
+#include "Enums.hpp"
+
+// seconds of silence before a client is sent a PING
+#define DEFAULT_PING_INTERVAL 120
+// seconds a client has to answer a PING
+#define DEFAULT_PING_TIMEOUT 60
+// seconds a new connection has to complete PASS/NICK/USER
+#define DEFAULT_REGISTRATION_TIMEOUT 30
+// queued output above which channel chatter to a client is dropped
+#define DEFAULT_SENDQ_HIGH_WATER (64 * 1024)
+// queued output at which a client is disconnected as a slow consumer
+#define DEFAULT_SENDQ_LIMIT (1024 * 1024)
+
+// bytes of recent messages each channel keeps for CHATHISTORY
+#define DEFAULT_HISTORY_BYTES (16 * 1024)
+
+// name the server puts in front of its replies
+#define DEFAULT_SERVER_NAME "irc.local"
+
+// startup options shared by every shard of the server
+struct ServerConfig {
+//	readiness backend of each event loop
+	PollerBackend backend = POLLER_EPOLL;
+//	number of event loops, each with its own listening socket & clients
+	size_t threads = 1;
+//	maximum number of clients, 0 derives it from the fd limit
+	size_t maxClients = 0;
+//	maximum open connections per source address, 0 for no limit
+	size_t maxPerIp = 0;
+//	maximum new connections per source address within CONNECT_RATE_WINDOW, 0 for no limit
+	size_t connectRate = 0;
+//	sendq size in bytes above which low priority lines are dropped
+	size_t sendqHighWater = DEFAULT_SENDQ_HIGH_WATER;
+//	sendq size in bytes a client may not exceed, it is closed instead
+	size_t sendqLimit = DEFAULT_SENDQ_LIMIT;
+//	keepalive & registration deadlines in seconds, 0 disables them
+	size_t pingInterval = DEFAULT_PING_INTERVAL;
+	size_t pingTimeout = DEFAULT_PING_TIMEOUT;
+	size_t registrationTimeout = DEFAULT_REGISTRATION_TIMEOUT;
+//	source of numeric replies & server PINGs
+	std::string serverName = DEFAULT_SERVER_NAME;
+//	per channel byte budget of the message history, 0 disables it
+	size_t historyBytes = DEFAULT_HISTORY_BYTES;
+};
+
+#endif //IRC_SERVERCONFIG_H
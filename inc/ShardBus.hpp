@@ -0,0 +1,155 @@
+//
+// Created on 10/18/26.
+//
+
+#ifndef IRC_SHARDBUS_H
+#define IRC_SHARDBUS_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <ctime>
+#include <cstdint>
+#include "Enums.hpp"
+#include "CaseMapping.hpp"
+#include "ChannelHistory.hpp"
+
+// a message posted from one shard to another
+struct ShardMessage {
+	ShardMessageType type;
+//	channel and/or nickname the message is addressed to
+	std::string channel;
+	std::string nick;
+//	every channel of a SHARD_CHANNELS_LINE
+	std::vector<std::string> channels;
+//	fully rendered line to deliver to the local recipients
+	std::string line;
+//	topic state for SHARD_CHANNEL_TOPIC
+	std::string topic;
+	std::string topicSetBy;
+	time_t topicSetTime;
+//	status a SHARD_CHANNEL_OPERATOR gives (true) or takes from nick
+	bool operatorStatus = false;
+//	priority of line for the local recipients
+	SendPriority priority = SEND_NORMAL;
+};
+
+// server wide state of a channel, its members & their status stay with the shard they are connected to
+struct ChannelState {
+//	name the channel was created with
+	std::string name;
+	std::string key;
+	bool inviteOnly = false;
+	bool topicRestricted = false;
+	size_t userLimit = 0;
+//	joined members on every shard, checked against userLimit
+	size_t userCount = 0;
+//	joined members per shard, only shards with members get the lines of the channel
+	std::vector<size_t> shardMembers;
+	std::string topic;
+	std::string topicSetBy;
+	time_t topicSetTime = 0;
+};
+
+// message passing between the event loops of a multi threaded server,
+// every shard owns one mailbox that only it drains
+class ShardBus {
+	public:
+		ShardBus(size_t shardCount, size_t historyBytes);
+		~ShardBus();
+
+		size_t GetShardCount() const;
+		int GetWakeFd(size_t shard) const;
+
+//		mailboxes
+		void Post(size_t shard, const ShardMessage &msg) const;
+		void PostToChannelShards(size_t fromShard, const ShardMessage &msg) const;
+		void Drain(size_t shard, std::vector<ShardMessage> &messages);
+
+//		server wide nickname directory, keeps nicks unique across shards
+		bool ClaimNick(const std::string &nick, size_t shard);
+		void ReleaseNick(const std::string &nick, size_t shard);
+		int FindNick(const std::string &nick) const;
+
+//		server wide channel directory, decides every join so modes & operators hold on every shard
+		JoinResult JoinChannel(const std::string &name, std::string_view key, bool invited, const std::string &nick,
+			size_t shard, ChannelState &state);
+		void LeaveChannel(const std::string &name, const std::string &nick, size_t shard);
+		bool FindChannel(const std::string &name, ChannelState &state) const;
+//		applies change to the state of a channel under the directory lock, nothing happens if it does not exist
+		template <typename Change>
+		void ChangeChannel(const std::string &name, Change change) {
+			std::unique_lock<std::shared_mutex> guard(_channelLock);
+			ChannelDirectory::iterator it = _channels.find(name);
+			if (it != _channels.end()) {
+				change(it->second.state);
+			}
+		}
+//		members of every shard by nick, for NAMES
+		void RenameMember(const std::string &name, const std::string &oldNick, const std::string &newNick);
+		void SetMemberOperator(const std::string &name, const std::string &nick, bool isOperator);
+//		history of a channel, shared by the shards so members joining on any of them see the same lines
+		void AppendHistory(const std::string &name, uint64_t msgid, int64_t timeMs, std::string_view line);
+		void GetHistoryUsage(size_t &bytes, size_t &channels) const;
+//		calls read(history) under the history lock, false if the channel does not exist
+		template <typename Read>
+		bool ReadHistory(const std::string &name, Read read) const {
+			std::shared_lock<std::shared_mutex> guard(_channelLock);
+			ChannelDirectory::const_iterator it = _channels.find(name);
+			if (it == _channels.end()) {
+				return false;
+			}
+			std::lock_guard<std::mutex> historyGuard(it->second.historyLock);
+			read(it->second.history);
+			return true;
+		}
+//		calls visit(nick, isOperator) for every member of a channel under the directory lock
+		template <typename Visit>
+		void ForEachMember(const std::string &name, Visit visit) const {
+			std::shared_lock<std::shared_mutex> guard(_channelLock);
+			ChannelDirectory::const_iterator it = _channels.find(name);
+			if (it == _channels.end()) {
+				return;
+			}
+			for (const std::pair<const std::string, bool> &member : it->second.members) {
+				visit(member.first, member.second);
+			}
+		}
+
+	private:
+		struct Mailbox {
+			std::mutex lock;
+			std::vector<ShardMessage> messages;
+//			read end is registered with the shard's poller, one byte wakes it up
+			int wakeFds[2];
+		};
+
+//		nickname to owning shard, names compare under the RFC 1459 casemapping
+		typedef std::unordered_map<std::string, size_t, CaseFoldHash, CaseFoldEqual> NickDirectory;
+//		nick of a member to its operator status
+		typedef std::unordered_map<std::string, bool, CaseFoldHash, CaseFoldEqual> ChannelRoster;
+		struct ChannelEntry {
+			ChannelState state;
+			ChannelRoster members;
+//			shards append under a shared directory lock, so the history has a lock of its own
+			mutable std::mutex historyLock;
+			ChannelHistory history;
+		};
+//		channel name to its state & members, entries are kept like the channels of the shards
+		typedef std::unordered_map<std::string, ChannelEntry, CaseFoldHash, CaseFoldEqual> ChannelDirectory;
+
+		ShardBus(const ShardBus &);
+		ShardBus& operator=(const ShardBus &);
+
+		std::vector<Mailbox*> _mailboxes;
+		mutable std::shared_mutex _nickLock;
+		NickDirectory _nicks;
+		mutable std::shared_mutex _channelLock;
+		ChannelDirectory _channels;
+		size_t _historyBytes;
+};
+
+#endif //IRC_SHARDBUS_H
@@ -0,0 +1,60 @@
+//
+// Created on 10/18/26.
+//
+
+#ifndef IRC_TIMERWHEEL_H
+#define IRC_TIMERWHEEL_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// resolution of the wheel
+#define TIMER_TICK_MS 100
+// slots per level, a power of two
+#define TIMER_WHEEL_BITS 6
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)
+// levels, covering TIMER_WHEEL_SLOTS^TIMER_WHEEL_LEVELS ticks (~19 days)
+#define TIMER_WHEEL_LEVELS 4
+
+// hierarchical timing wheel with one timer per id (client fd), schedule & cancel are O(1)
+// timers are kept in intrusive lists of indices so growing the node table never invalidates a slot
+class TimerWheel {
+	public:
+		TimerWheel();
+		~TimerWheel();
+
+//		starts counting ticks from nowMs, must be called before the first Schedule
+		void Start(uint64_t nowMs);
+//		(re)arms the timer of id to fire at expiryMs
+		void Schedule(int id, uint64_t expiryMs);
+		void Cancel(int id);
+		bool IsScheduled(int id) const;
+
+//		moves the wheel to nowMs & appends the ids of every expired timer
+		void Advance(uint64_t nowMs, std::vector<int> &expired);
+//		returns how long the event loop may sleep, -1 if no timer is armed
+		int GetTimeout(uint64_t nowMs) const;
+		size_t GetCount() const;
+
+	private:
+		struct Node {
+			int prev;
+			int next;
+			uint64_t expiryTick;
+//			level * TIMER_WHEEL_SLOTS + slot, -1 while not scheduled
+			int slot;
+		};
+
+		void _link(int id);
+		void _unlink(int id);
+		void _cascade(int level);
+
+		std::vector<Node> _nodes;
+//		head id of every slot list, -1 when empty
+		int _slots[TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS];
+		uint64_t _currentTick;
+		size_t _count;
+};
+
+#endif //IRC_TIMERWHEEL_H
@@ -9,6 +9,16 @@
 #include <string>
 #include <stdexcept>
 #include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <csignal>
+#include <pthread.h>
 #include "Server.hpp"
+#include "ServerConfig.hpp"
+#include "ShardBus.hpp"
+
+// upper bound for --threads
+#define MAX_THREADS 256
 
 #endif //IRC_MAIN_H
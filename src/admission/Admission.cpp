@@ -0,0 +1,189 @@
+//
+// Created on 10/18/26.
+//
+
+#include "Admission.hpp"
+#include <cstring>
+
+#define ADMISSION_INITIAL_CAPACITY 64
+
+/* --------------------------------------------------------------------------------- */
+/* Constructors & Destructors                                                        */
+/* --------------------------------------------------------------------------------- */
+Admission::Admission() : _maxPerIp(0), _connectRate(0), _entries(ADMISSION_INITIAL_CAPACITY), _used(0) {
+	std::memset(&_stats, 0, sizeof(_stats));
+}
+
+Admission::Admission(size_t maxPerIp, size_t connectRate)
+	: _maxPerIp(maxPerIp), _connectRate(connectRate), _entries(ADMISSION_INITIAL_CAPACITY), _used(0) {
+	std::memset(&_stats, 0, sizeof(_stats));
+}
+
+Admission::~Admission() {}
+
+/* --------------------------------------------------------------------------------- */
+/* Admission                                                                         */
+/* --------------------------------------------------------------------------------- */
+// decides whether a new connection may stay & accounts for it if so
+AdmissionResult Admission::Admit(uint32_t address, size_t currentClients, size_t maxClients, time_t now) {
+	if (maxClients > 0 && currentClients >= maxClients) {
+		++_stats.rejectedMaxClients;
+		return ADMISSION_MAX_CLIENTS;
+	}
+	// no per address limits configured or unknown peer, nothing to track
+	if ((_maxPerIp == 0 && _connectRate == 0) || address == 0) {
+		++_stats.accepted;
+		return ADMISSION_OK;
+	}
+	Entry *entry = _find(address);
+	if (entry && now - static_cast<time_t>(entry->windowStart) >= CONNECT_RATE_WINDOW) {
+		entry->windowStart = static_cast<uint32_t>(now);
+		entry->recentConnects = 0;
+	}
+	if (entry && _maxPerIp > 0 && entry->connections >= _maxPerIp) {
+		++_stats.rejectedPerIp;
+		return ADMISSION_PER_IP_LIMIT;
+	}
+	if (entry && _connectRate > 0 && entry->recentConnects >= _connectRate) {
+		++_stats.rejectedRate;
+		return ADMISSION_RATE_LIMIT;
+	}
+	if (!entry) {
+		entry = &_insert(address, now);
+	}
+	if (entry->connections < UINT16_MAX) {
+		++entry->connections;
+	}
+	if (entry->recentConnects < UINT16_MAX) {
+		++entry->recentConnects;
+	}
+	++_stats.accepted;
+	return ADMISSION_OK;
+}
+
+// forgets a closed connection of an admitted address
+void Admission::Release(uint32_t address, time_t now) {
+	if (address == 0) {
+		return;
+	}
+	Entry *entry = _find(address);
+	if (!entry) {
+		return;
+	}
+	if (entry->connections > 0) {
+		--entry->connections;
+	}
+	if (_isIdle(*entry, now)) {
+		_erase(entry);
+	}
+}
+
+// counts a failed accept call
+void Admission::CountAcceptError() {
+	++_stats.acceptErrors;
+}
+
+// returns the admission counters
+const AdmissionStats& Admission::GetStats() const {
+	return _stats;
+}
+
+// returns the number of addresses currently tracked
+size_t Admission::GetTrackedAddresses() const {
+	return _used;
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Table                                                                             */
+/* --------------------------------------------------------------------------------- */
+// spreads addresses of the same subnet over the table, every input bit reaches the low bits
+static size_t _hashAddress(uint32_t address) {
+	address ^= address >> 16;
+	address *= 0x7feb352du;
+	address ^= address >> 15;
+	address *= 0x846ca68bu;
+	address ^= address >> 16;
+	return static_cast<size_t>(address);
+}
+
+// an entry without connections whose rate window expired carries no information
+bool Admission::_isIdle(const Entry &entry, time_t now) const {
+	return entry.connections == 0 && now - static_cast<time_t>(entry.windowStart) >= CONNECT_RATE_WINDOW;
+}
+
+// returns the entry of an address, nullptr if it is not tracked
+Admission::Entry* Admission::_find(uint32_t address) {
+	size_t mask = _entries.size() - 1;
+	for (size_t i = _hashAddress(address) & mask; _entries[i].address != 0; i = (i + 1) & mask) {
+		if (_entries[i].address == address) {
+			return &_entries[i];
+		}
+	}
+	return nullptr;
+}
+
+// adds an address, grows the table above 70% load & drops idle entries on the way
+Admission::Entry& Admission::_insert(uint32_t address, time_t now) {
+	if ((_used + 1) * 10 > _entries.size() * 7) {
+		_rehash(_entries.size() * 2, now);
+	}
+	size_t mask = _entries.size() - 1;
+	size_t i = _hashAddress(address) & mask;
+	while (_entries[i].address != 0) {
+		i = (i + 1) & mask;
+	}
+	_entries[i].address = address;
+	_entries[i].connections = 0;
+	_entries[i].recentConnects = 0;
+	_entries[i].windowStart = static_cast<uint32_t>(now);
+	++_used;
+	return _entries[i];
+}
+
+// removes an entry & shifts back the entries of its probe chain
+void Admission::_erase(Entry *entry) {
+	size_t mask = _entries.size() - 1;
+	size_t hole = static_cast<size_t>(entry - _entries.data());
+	size_t i = (hole + 1) & mask;
+	while (_entries[i].address != 0) {
+		size_t home = _hashAddress(_entries[i].address) & mask;
+		// move the entry into the hole unless its home lies cyclically in (hole, i]
+		if ((i > hole && (home <= hole || home > i)) || (i < hole && (home <= hole && home > i))) {
+			_entries[hole] = _entries[i];
+			hole = i;
+		}
+		i = (i + 1) & mask;
+	}
+	_entries[hole].address = 0;
+	--_used;
+}
+
+// rebuilds the table with a new capacity, idle entries are dropped
+void Admission::_rehash(size_t capacity, time_t now) {
+	std::vector<Entry> old;
+	old.swap(_entries);
+	size_t live = 0;
+	for (size_t i = 0; i < old.size(); ++i) {
+		if (old[i].address != 0 && !_isIdle(old[i], now)) {
+			++live;
+		}
+	}
+	// shrink back if dropping idle entries freed most of the table
+	while (capacity > ADMISSION_INITIAL_CAPACITY && (live + 1) * 10 <= (capacity / 2) * 7) {
+		capacity /= 2;
+	}
+	_entries.assign(capacity, Entry());
+	_used = 0;
+	size_t mask = capacity - 1;
+	for (size_t i = 0; i < old.size(); ++i) {
+		if (old[i].address == 0 || _isIdle(old[i], now)) {
+			continue;
+		}
+		size_t j = _hashAddress(old[i].address) & mask;
+		while (_entries[j].address != 0) {
+			j = (j + 1) & mask;
+		}
+		_entries[j] = old[i];
+		++_used;
+	}
+}
@@ -0,0 +1,106 @@
+//
+// Created on 10/18/26.
+//
+
+#include "Arena.hpp"
+#include <cstring>
+
+/* --------------------------------------------------------------------------------- */
+/* Constructors & Destructors                                                        */
+/* --------------------------------------------------------------------------------- */
+Arena::Arena() : _current(0), _used(0), _allocated(0) {
+	std::memset(&_stats, 0, sizeof(_stats));
+}
+
+Arena::~Arena() {
+	Reset();
+	for (size_t i = 0; i < _blocks.size(); ++i) {
+		delete[] _blocks[i];
+	}
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Allocation                                                                        */
+/* --------------------------------------------------------------------------------- */
+// returns size bytes aligned to alignment, valid until the next Reset
+void* Arena::Allocate(size_t size, size_t alignment) {
+	_allocated += size;
+	if (_allocated > _stats.peakBytes) {
+		_stats.peakBytes = _allocated;
+	}
+	if (size > ARENA_BLOCK_SIZE / 4) {
+		// would waste most of a block, served by the heap until the reset
+		char *data = new char[size];
+		_oversized.push_back(data);
+		++_stats.oversized;
+		return data;
+	}
+	if (_blocks.empty()) {
+		_nextBlock();
+	}
+	size_t offset = (_used + alignment - 1) & ~(alignment - 1);
+	if (offset + size > ARENA_BLOCK_SIZE) {
+		_nextBlock();
+		offset = 0;
+	}
+	_used = offset + size;
+	return _blocks[_current] + offset;
+}
+
+// gives the bytes back if they are the latest allocation, which lets a growing string reuse its tail
+void Arena::Deallocate(void *ptr, size_t size) {
+	char *data = static_cast<char *>(ptr);
+	if (!_blocks.empty() && data + size == _blocks[_current] + _used && data >= _blocks[_current]) {
+		_used -= size;
+		// the bytes no longer count towards the peak
+		_allocated -= size;
+	}
+}
+
+// moves to the next block, allocating it on first use
+void Arena::_nextBlock() {
+	if (!_blocks.empty()) {
+		++_current;
+	}
+	if (_current == _blocks.size()) {
+		_blocks.push_back(new char[ARENA_BLOCK_SIZE]);
+		_stats.blocks = _blocks.size();
+	}
+	_used = 0;
+}
+
+// invalidates everything allocated since the last reset, the blocks are reused
+void Arena::Reset() {
+	for (size_t i = 0; i < _oversized.size(); ++i) {
+		delete[] _oversized[i];
+	}
+	_oversized.clear();
+	_current = 0;
+	_used = 0;
+	_allocated = 0;
+}
+
+// copies the concatenation of parts into the arena
+std::string_view Arena::Concat(std::initializer_list<std::string_view> parts) {
+	size_t size = 0;
+	for (std::string_view part : parts) {
+		size += part.size();
+	}
+	char *data = static_cast<char *>(Allocate(size, 1));
+	size_t offset = 0;
+	for (std::string_view part : parts) {
+		if (!part.empty()) {
+			std::memcpy(data + offset, part.data(), part.size());
+			offset += part.size();
+		}
+	}
+	return std::string_view(data, size);
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Stats                                                                             */
+/* --------------------------------------------------------------------------------- */
+// returns the occupancy counters
+const ArenaStats& Arena::GetStats() const {
+	return _stats;
+}
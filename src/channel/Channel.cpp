@@ -8,7 +8,8 @@
 /* Constructors & Destructors                                                        */
 /* --------------------------------------------------------------------------------- */
 
-Channel::Channel() : _name(""), _password(""), _inviteOnly(false), _topic(""), _topicOnlySettableByOperator(false) {}
+Channel::Channel() : _name(""), _password(""), _inviteOnly(false), _userLimit(0), _topic(""),
+	_topicOnlySettableByOperator(false), _topicSetTime(0) {}
 
 Channel::~Channel() {}
 
@@ -16,7 +17,7 @@ Channel::~Channel() {}
 /* Getters & Setters                                                                 */
 /* --------------------------------------------------------------------------------- */
 // returns the name of the channel
-std::string Channel::GetName() const {
+const std::string& Channel::GetName() const {
 	return _name;
 }
 
@@ -26,7 +27,7 @@ std::string Channel::GetPassword() const {
 }
 
 // returns the topic of the channel
-std::string Channel::GetTopic() const {
+const std::string& Channel::GetTopic() const {
 	return _topic;
 }
 
@@ -40,24 +41,24 @@ size_t Channel::GetUserLimit() const {
 	return _userLimit;
 }
 
-// returns the messages of the channel
-std::vector<std::string>& Channel::GetMessages() {
-	return _messages;
+// returns the recent messages of the channel
+ChannelHistory& Channel::GetHistory() {
+	return _history;
 }
 
-// returns the operators of the channel
-std::vector<int>& Channel::GetOperators() {
-	return _operators;
+// returns the recent messages of the channel
+const ChannelHistory& Channel::GetHistory() const {
+	return _history;
 }
 
-// returns the users of the channel
-std::vector<int>& Channel::GetUsers() {
-	return _users;
+// returns the members of the channel, iterating yields the joined users
+const ChannelMembers& Channel::GetMembers() const {
+	return _members;
 }
 
-// returns the invited users of the channel
-std::vector<int>& Channel::GetInvited() {
-	return _invited;
+// returns the number of joined users
+size_t Channel::GetUserCount() const {
+	return _members.size();
 }
 
 // sets the name of the channel
@@ -95,37 +96,45 @@ void Channel::SetUserLimit(size_t userLimit) {
 	_userLimit = userLimit;
 }
 
-// adds a user to the channel
-void Channel::AddUser(int user) {
-	_users.push_back(user);
+// adds a user to the channel, an invite is used up by joining
+void Channel::AddUser(const ClientHandle &user) {
+	_members.Clear(user.fd, MEMBER_INVITED);
+	_members.Set(user, MEMBER_JOINED);
 }
 
 // makes a user operator of the channel
-void Channel::MakeOperator(int user) {
-	if (IsUserOperator(user)) {
-		return;
-	}
-	_operators.push_back(user);
+void Channel::MakeOperator(const ClientHandle &user) {
+	_members.Set(user, MEMBER_OPERATOR);
 }
 
 // removes operator status from a user
 void Channel::RemoveOperator(const int user) {
-	auto it = std::find(_operators.begin(), _operators.end(), user);
-	if (it != _operators.end()) {
-		_operators.erase(it);
-	}
+	_members.Clear(user, MEMBER_OPERATOR);
 }
 
-// removes a user from the channel
+// removes a user & every status it had from the channel
 void Channel::RemoveUser(const int user) {
-	auto it = std::find(_users.begin(), _users.end(), user);
-	if (it != _users.end()) {
-		_users.erase(it);
-	}
+	_members.Remove(user);
 }
 
-bool Channel::IsUserOperator(int user) {
-	return std::find(_operators.begin(), _operators.end(), user) != _operators.end();
+// returns if a user joined the channel
+bool Channel::IsUser(const ClientHandle &user) const {
+	return _members.Has(user, MEMBER_JOINED);
+}
+
+// returns if a user is operator of the channel
+bool Channel::IsUserOperator(const ClientHandle &user) const {
+	return _members.Has(user, MEMBER_OPERATOR);
+}
+
+// lets a user join while the channel is invite only
+void Channel::Invite(const ClientHandle &user) {
+	_members.Set(user, MEMBER_INVITED);
+}
+
+// returns if a user was invited to the channel
+bool Channel::IsInvited(const ClientHandle &user) const {
+	return _members.Has(user, MEMBER_INVITED);
 }
 
 const std::string& Channel::GetTopicSetBy() const { 
@@ -0,0 +1,212 @@
+//
+// Created on 10/18/26.
+//
+
+#include "ChannelHistory.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+// first size of the byte ring, it doubles from there up to the budget
+#define HISTORY_INITIAL_BYTES 1024
+// first size of the entry ring
+#define HISTORY_INITIAL_ENTRIES 16
+
+/* --------------------------------------------------------------------------------- */
+/* Constructors & Destructors                                                        */
+/* --------------------------------------------------------------------------------- */
+ChannelHistory::ChannelHistory() : _budget(0), _head(0), _usedBytes(0), _first(0), _count(0) {}
+
+ChannelHistory::~ChannelHistory() {}
+
+/* --------------------------------------------------------------------------------- */
+/* Storage                                                                           */
+/* --------------------------------------------------------------------------------- */
+// sets the byte budget, 0 disables the history & drops what is stored
+void ChannelHistory::SetBudget(size_t bytes) {
+	_budget = bytes;
+	std::vector<char>().swap(_bytes);
+	std::vector<HistoryEntry>().swap(_entries);
+	_head = 0;
+	_usedBytes = 0;
+	_first = 0;
+	_count = 0;
+}
+
+// stores a line, evicting the oldest ones until it fits, lines above the budget are not stored
+void ChannelHistory::Append(uint64_t msgid, int64_t timeMs, std::string_view line) {
+	if (line.empty() || line.size() > _budget) {
+		return;
+	}
+	_makeRoom(line.size());
+	if (_count == _entries.size()) {
+		_growEntries();
+	}
+	std::memcpy(_bytes.data() + _head, line.data(), line.size());
+	_entries[(_first + _count) % _entries.size()] = HistoryEntry{msgid, timeMs, static_cast<uint32_t>(_head),
+		static_cast<uint32_t>(line.size())};
+	++_count;
+	_head += line.size();
+	_usedBytes += line.size();
+}
+
+// evicts the oldest lines that overlap the size bytes at _head, wrapping to offset 0 if they do not fit before the end
+void ChannelHistory::_makeRoom(size_t size) {
+	if (_usedBytes + size > _bytes.size() && _bytes.size() < _budget) {
+		_growBytes(size);
+	}
+	// lines ahead of _head are the oldest, the ones up to the end are lost when wrapping
+	if (_head + size > _bytes.size()) {
+		while (_count > 0 && At(0).offset >= _head) {
+			_popOldest();
+		}
+		_head = 0;
+	}
+	while (_count > 0 && At(0).offset >= _head && At(0).offset < _head + size) {
+		_popOldest();
+	}
+}
+
+// evicts the oldest line
+void ChannelHistory::_popOldest() {
+	_usedBytes -= _entries[_first].size;
+	_first = (_first + 1) % _entries.size();
+	--_count;
+}
+
+// enlarges the byte ring to hold size more bytes within the budget, the lines are copied to its start in order
+void ChannelHistory::_growBytes(size_t size) {
+	size_t capacity = std::max(_bytes.size() * 2, static_cast<size_t>(HISTORY_INITIAL_BYTES));
+	while (capacity < _usedBytes + size) {
+		capacity *= 2;
+	}
+	capacity = std::min(capacity, _budget);
+	std::vector<char> bytes(capacity);
+	size_t offset = 0;
+	for (size_t i = 0; i < _count; ++i) {
+		HistoryEntry &entry = _entries[(_first + i) % _entries.size()];
+		std::memcpy(bytes.data() + offset, _bytes.data() + entry.offset, entry.size);
+		entry.offset = static_cast<uint32_t>(offset);
+		offset += entry.size;
+	}
+	_bytes.swap(bytes);
+	_head = offset;
+}
+
+// doubles the entry ring, the entries are copied to its start in order
+void ChannelHistory::_growEntries() {
+	std::vector<HistoryEntry> entries(std::max(_entries.size() * 2, static_cast<size_t>(HISTORY_INITIAL_ENTRIES)));
+	for (size_t i = 0; i < _count; ++i) {
+		entries[i] = _entries[(_first + i) % _entries.size()];
+	}
+	_entries.swap(entries);
+	_first = 0;
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Lookup                                                                            */
+/* --------------------------------------------------------------------------------- */
+// returns the number of stored lines
+size_t ChannelHistory::size() const {
+	return _count;
+}
+
+// returns the entry at index, 0 is the oldest
+const HistoryEntry& ChannelHistory::At(size_t index) const {
+	return _entries[(_first + index) % _entries.size()];
+}
+
+// returns the line of an entry including its CRLF, valid until the next Append
+std::string_view ChannelHistory::GetLine(const HistoryEntry &entry) const {
+	return std::string_view(_bytes.data() + entry.offset, entry.size);
+}
+
+// returns the index of a msgid, npos if it was evicted or never stored
+size_t ChannelHistory::Find(uint64_t msgid) const {
+	// references usually point at recent lines
+	for (size_t i = _count; i > 0; --i) {
+		if (At(i - 1).msgid == msgid) {
+			return i - 1;
+		}
+	}
+	return npos;
+}
+
+// returns the index of the first entry not older than timeMs, size() if there is none
+size_t ChannelHistory::FindTime(int64_t timeMs) const {
+	// lines relayed by other shards may be a little out of order, so no binary search
+	for (size_t i = 0; i < _count; ++i) {
+		if (At(i).timeMs >= timeMs) {
+			return i;
+		}
+	}
+	return _count;
+}
+
+// returns the bytes of the stored lines
+size_t ChannelHistory::GetUsedBytes() const {
+	return _usedBytes;
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Timestamps                                                                        */
+/* --------------------------------------------------------------------------------- */
+// writes timeMs as YYYY-MM-DDThh:mm:ss.sssZ into out
+void ChannelHistory::FormatTime(int64_t timeMs, char *out) {
+	time_t seconds = static_cast<time_t>(timeMs / 1000);
+	struct tm utc;
+	gmtime_r(&seconds, &utc);
+	char text[64];
+	snprintf(text, sizeof(text), "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ", utc.tm_year + 1900, utc.tm_mon + 1,
+		utc.tm_mday, utc.tm_hour, utc.tm_min, utc.tm_sec, static_cast<int>(timeMs % 1000));
+	std::memcpy(out, text, HISTORY_TIME_SIZE);
+}
+
+// reads count digits at pos into value & moves pos past them
+static bool readDigits(std::string_view text, size_t &pos, size_t count, int &value) {
+	value = 0;
+	for (size_t end = pos + count; pos < end; ++pos) {
+		if (pos >= text.size() || text[pos] < '0' || text[pos] > '9') {
+			return false;
+		}
+		value = value * 10 + (text[pos] - '0');
+	}
+	return true;
+}
+
+// reads the separator c at pos & moves pos past it
+static bool readChar(std::string_view text, size_t &pos, char c) {
+	if (pos >= text.size() || text[pos] != c) {
+		return false;
+	}
+	++pos;
+	return true;
+}
+
+// parses YYYY-MM-DDThh:mm:ss[.sss]Z into milliseconds since the epoch
+bool ChannelHistory::ParseTime(std::string_view text, int64_t &timeMs) {
+	struct tm utc;
+	std::memset(&utc, 0, sizeof(utc));
+	int millis = 0;
+	size_t pos = 0;
+	bool valid = readDigits(text, pos, 4, utc.tm_year) && readChar(text, pos, '-')
+		&& readDigits(text, pos, 2, utc.tm_mon) && readChar(text, pos, '-')
+		&& readDigits(text, pos, 2, utc.tm_mday) && readChar(text, pos, 'T')
+		&& readDigits(text, pos, 2, utc.tm_hour) && readChar(text, pos, ':')
+		&& readDigits(text, pos, 2, utc.tm_min) && readChar(text, pos, ':')
+		&& readDigits(text, pos, 2, utc.tm_sec);
+	if (valid && pos < text.size() && text[pos] == '.') {
+		++pos;
+		valid = readDigits(text, pos, 3, millis);
+	}
+	valid = valid && readChar(text, pos, 'Z') && pos == text.size();
+	if (!valid || utc.tm_mon < 1 || utc.tm_mon > 12 || utc.tm_mday < 1 || utc.tm_mday > 31 || utc.tm_hour > 23
+		|| utc.tm_min > 59 || utc.tm_sec > 60) {
+		return false;
+	}
+	utc.tm_year -= 1900;
+	utc.tm_mon -= 1;
+	timeMs = static_cast<int64_t>(timegm(&utc)) * 1000 + millis;
+	return true;
+}
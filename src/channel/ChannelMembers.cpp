@@ -0,0 +1,163 @@
+//
+// Created on 10/18/26.
+//
+
+#include "ChannelMembers.hpp"
+#include <utility>
+
+/* --------------------------------------------------------------------------------- */
+/* Constructors & Destructors                                                        */
+/* --------------------------------------------------------------------------------- */
+ChannelMembers::ChannelMembers() : _joined(0), _shift(32) {}
+
+ChannelMembers::~ChannelMembers() {}
+
+/* --------------------------------------------------------------------------------- */
+/* Members                                                                           */
+/* --------------------------------------------------------------------------------- */
+// returns if a client has any of the given bits, bits of an earlier client on the same fd do not count
+bool ChannelMembers::Has(const ClientHandle &client, unsigned flag) const {
+	if (_entries.empty()) {
+		return false;
+	}
+	int pos = _slots[_findSlot(client.fd)];
+	return pos != -1 && _entries[pos].generation == client.generation && (_entries[pos].flags & flag) != 0;
+}
+
+// sets bits of a client, adds an entry if it has none
+void ChannelMembers::Set(const ClientHandle &client, unsigned flag) {
+	if (!_entries.empty()) {
+		int pos = _slots[_findSlot(client.fd)];
+		if (pos != -1 && _entries[pos].generation != client.generation) {
+			// left behind by the previous client on this fd
+			Remove(client.fd);
+		}
+	}
+	if ((_entries.size() + 1) * 2 > _slots.size()) {
+		_grow();
+	}
+	size_t slot = _findSlot(client.fd);
+	if (_slots[slot] == -1) {
+		ChannelMember entry = {client.fd, 0, client.generation};
+		_slots[slot] = static_cast<int>(_entries.size());
+		_entries.push_back(entry);
+	}
+	size_t pos = static_cast<size_t>(_slots[slot]);
+	if ((flag & MEMBER_JOINED) && !(_entries[pos].flags & MEMBER_JOINED)) {
+		// becomes part of the joined block
+		_swapEntries(pos, _joined);
+		pos = _joined++;
+	}
+	_entries[pos].flags |= flag;
+}
+
+// clears bits of fd, drops its entry once no bit is left
+void ChannelMembers::Clear(int fd, unsigned flag) {
+	if (_entries.empty()) {
+		return;
+	}
+	size_t slot = _findSlot(fd);
+	if (_slots[slot] == -1) {
+		return;
+	}
+	size_t pos = static_cast<size_t>(_slots[slot]);
+	unsigned old = _entries[pos].flags;
+	_entries[pos].flags &= ~flag;
+	if ((old & MEMBER_JOINED) && !(_entries[pos].flags & MEMBER_JOINED)) {
+		// leaves the joined block
+		_swapEntries(pos, --_joined);
+		pos = _joined;
+	}
+	if (_entries[pos].flags == 0) {
+		size_t last = _entries.size() - 1;
+		_swapEntries(pos, last);
+		_eraseSlot(_findSlot(fd));
+		_entries.pop_back();
+	}
+}
+
+// drops the entry of fd
+void ChannelMembers::Remove(int fd) {
+	Clear(fd, MEMBER_ALL);
+}
+
+// returns the first joined member
+const ChannelMember* ChannelMembers::begin() const {
+	return _entries.data();
+}
+
+// returns past the last joined member
+const ChannelMember* ChannelMembers::end() const {
+	return _entries.data() + _joined;
+}
+
+// returns the number of joined members
+size_t ChannelMembers::size() const {
+	return _joined;
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Index                                                                             */
+/* --------------------------------------------------------------------------------- */
+// returns the slot an fd hashes to, fibonacci hashing spreads sequential fds
+size_t ChannelMembers::_home(int fd) const {
+	return static_cast<size_t>((static_cast<uint32_t>(fd) * 2654435769u) >> _shift);
+}
+
+// returns the slot holding fd, or the empty slot it would be inserted at
+size_t ChannelMembers::_findSlot(int fd) const {
+	size_t mask = _slots.size() - 1;
+	size_t slot = _home(fd);
+	while (_slots[slot] != -1 && _entries[_slots[slot]].fd != fd) {
+		slot = (slot + 1) & mask;
+	}
+	return slot;
+}
+
+// exchanges two entries & points the index at their new positions
+void ChannelMembers::_swapEntries(size_t a, size_t b) {
+	if (a == b) {
+		return;
+	}
+	// look both up before the swap, probing compares against the entries the slots point at
+	size_t slotA = _findSlot(_entries[a].fd);
+	size_t slotB = _findSlot(_entries[b].fd);
+	std::swap(_entries[a], _entries[b]);
+	_slots[slotA] = static_cast<int>(b);
+	_slots[slotB] = static_cast<int>(a);
+}
+
+// empties a slot & shifts the rest of its probe run back so no lookup stops early
+void ChannelMembers::_eraseSlot(size_t slot) {
+	size_t mask = _slots.size() - 1;
+	size_t hole = slot;
+	size_t next = slot;
+	_slots[hole] = -1;
+	while (true) {
+		next = (next + 1) & mask;
+		if (_slots[next] == -1) {
+			return;
+		}
+		// an entry may move into the hole unless its home lies cyclically in (hole, next]
+		size_t home = _home(_entries[_slots[next]].fd);
+		bool stays = hole <= next ? (hole < home && home <= next) : (hole < home || home <= next);
+		if (!stays) {
+			_slots[hole] = _slots[next];
+			_slots[next] = -1;
+			hole = next;
+		}
+	}
+}
+
+// doubles the index & reinserts every entry
+void ChannelMembers::_grow() {
+	size_t size = _slots.empty() ? CHANNEL_MEMBERS_INITIAL_SLOTS : _slots.size() * 2;
+	_slots.assign(size, -1);
+	_shift = 32;
+	while ((static_cast<size_t>(1) << (32 - _shift)) < size) {
+		--_shift;
+	}
+	for (size_t i = 0; i < _entries.size(); ++i) {
+		_slots[_findSlot(_entries[i].fd)] = static_cast<int>(i);
+	}
+}
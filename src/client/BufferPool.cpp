@@ -0,0 +1,77 @@
+//
+// Created on 10/18/26.
+//
+
+#include "BufferPool.hpp"
+#include <cstring>
+
+/* --------------------------------------------------------------------------------- */
+/* Constructors & Destructors                                                        */
+/* --------------------------------------------------------------------------------- */
+BufferPool::BufferPool() : _free(nullptr) {
+	std::memset(&_stats, 0, sizeof(_stats));
+}
+
+BufferPool::~BufferPool() {
+	for (size_t i = 0; i < _blocks.size(); ++i) {
+		delete[] _blocks[i];
+	}
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Slabs                                                                             */
+/* --------------------------------------------------------------------------------- */
+// hands out a free slab, allocates a new block if none is left
+char* BufferPool::Acquire() {
+	if (!_free) {
+		_grow();
+	}
+	char *slab = _free;
+	std::memcpy(&_free, slab, sizeof(_free));
+	++_stats.slabsInUse;
+	return slab;
+}
+
+// puts a slab back on the free list
+void BufferPool::Release(char *slab) {
+	std::memcpy(slab, &_free, sizeof(_free));
+	_free = slab;
+	--_stats.slabsInUse;
+}
+
+// returns the capacity of one slab
+size_t BufferPool::GetSlabSize() const {
+	return RECV_SLAB_SIZE;
+}
+
+// allocates a block & chains its slabs into the free list
+void BufferPool::_grow() {
+	char *block = new char[RECV_SLAB_SIZE * RECV_SLABS_PER_BLOCK];
+	_blocks.push_back(block);
+	for (size_t i = RECV_SLABS_PER_BLOCK; i-- > 0; ) {
+		char *slab = block + i * RECV_SLAB_SIZE;
+		std::memcpy(slab, &_free, sizeof(_free));
+		_free = slab;
+	}
+	_stats.slabs += RECV_SLABS_PER_BLOCK;
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Stats                                                                             */
+/* --------------------------------------------------------------------------------- */
+// accounts for a heap buffer that replaced a slab
+void BufferPool::CountOversized(size_t bytes) {
+	++_stats.oversizedInUse;
+	_stats.oversizedBytes += bytes;
+}
+
+// accounts for a freed heap buffer
+void BufferPool::UncountOversized(size_t bytes) {
+	--_stats.oversizedInUse;
+	_stats.oversizedBytes -= bytes;
+}
+
+// returns the occupancy of the pool
+const BufferPoolStats& BufferPool::GetStats() const {
+	return _stats;
+}
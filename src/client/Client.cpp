@@ -4,15 +4,21 @@
 
 #include "Client.hpp"
 #include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <arpa/inet.h>
 
 /* --------------------------------------------------------------------------------- */
 /* Constructors & Destructors                                                        */
 /* --------------------------------------------------------------------------------- */
-Client::Client() : _fd(-1), _userName(""), _nickName(""), _authenticated(false), _msgBuffer("") {
+Client::Client() : _fd(-1), _userName(""), _nickName(""), _authenticated(false), _address(0), _sendOffset(0), _pendingBytes(0), _writeArmed(false), _flushScheduled(false), _registered(false), _lastActivity(0), _pingSentAt(0), _rtt(-1), _sendqExceeded(false), _droppedMessages(0) {
 }
 
 
-Client::Client(int fd) : _fd(fd), _userName(""), _nickName(""), _authenticated(false), _msgBuffer("") {
+Client::Client(int fd) : _fd(fd), _userName(""), _nickName(""), _authenticated(false), _address(0), _sendOffset(0), _pendingBytes(0), _writeArmed(false), _flushScheduled(false), _registered(false), _lastActivity(0), _pingSentAt(0), _rtt(-1), _sendqExceeded(false), _droppedMessages(0) {
+}
+
+Client::Client(int fd, BufferPool *recvPool) : _fd(fd), _userName(""), _nickName(""), _authenticated(false), _address(0), _recvBuffer(recvPool), _sendOffset(0), _pendingBytes(0), _writeArmed(false), _flushScheduled(false), _registered(false), _lastActivity(0), _pingSentAt(0), _rtt(-1), _sendqExceeded(false), _droppedMessages(0) {
 }
 
 Client::~Client() {}
@@ -22,12 +28,12 @@ Client::~Client() {}
 /* --------------------------------------------------------------------------------- */
 
 // returns the username of the client
-std::string Client::GetUserName() const {
+const std::string& Client::GetUserName() const {
 	return _userName;
 }
 
 // returns the nickname of the client
-std::string Client::GetNickName() const {
+const std::string& Client::GetNickName() const {
 	return _nickName;
 }
 
@@ -36,22 +42,21 @@ bool Client::GetAuthenticated() const {
 	return _authenticated;
 }
 
-std::string Client::GetMsgBuffer() {
-	return _msgBuffer;
-}
-
-void Client::SetMsgBuffer(std::string msgBuffer) {
-	_msgBuffer = msgBuffer;
+// returns the receive buffer of the client
+RecvBuffer& Client::GetRecvBuffer() {
+	return _recvBuffer;
 }
 
 // sets the username of the client
 void Client::SetUserName(std::string userName) {
 	_userName = userName;
+	_renderPrefix();
 }
 
 // sets the nickname of the client
 void Client::SetNickName(std::string nickName) {
 	_nickName = nickName;
+	_renderPrefix();
 }
 
 // sets if client is authenticated
@@ -61,4 +66,208 @@ void Client::SetAuthenticated(bool authenticated) {
 
 int Client::GetFd() const {
 	return _fd;
-}
\ No newline at end of file
+}
+/* --------------------------------------------------------------------------------- */
+/* Outbound Queue                                                                    */
+/* --------------------------------------------------------------------------------- */
+// appends a message to the outbound queue, small messages share a chunk
+void Client::QueueMessage(std::string_view msg) {
+	std::memcpy(ReserveMessage(msg.size()), msg.data(), msg.size());
+}
+
+// returns room for a size byte line at the end of the queue, the caller fills all of it
+char* Client::ReserveMessage(size_t size) {
+	if (_sendQueue.empty() || _sendQueue.back().GetSpace() < size) {
+		_sendQueue.push_back(SendBuffer(std::string_view(), size > SEND_CHUNK_SIZE ? size : SEND_CHUNK_SIZE));
+	}
+	_pendingBytes += size;
+	return _sendQueue.back().Extend(size);
+}
+
+// queues a reference to an encoded line, the bytes are shared with the other recipients
+void Client::QueueBuffer(const SendBuffer &buffer) {
+	_sendQueue.push_back(buffer);
+	_pendingBytes += buffer.GetSize();
+}
+
+// returns if there are bytes waiting to be sent
+bool Client::HasPendingOutput() const {
+	return _pendingBytes > 0;
+}
+
+// returns the number of bytes not yet sent
+size_t Client::GetPendingSize() const {
+	return _pendingBytes;
+}
+
+// fills iov with the unsent chunks for writev, returns the number of entries used
+int Client::GetPendingIovecs(struct iovec *iov, int maxIov) const {
+	int count = 0;
+	for (std::deque<SendBuffer>::const_iterator it = _sendQueue.begin(); it != _sendQueue.end() && count < maxIov; ++it) {
+		size_t offset = (count == 0) ? _sendOffset : 0;
+		iov[count].iov_base = const_cast<char *>(it->GetData() + offset);
+		iov[count].iov_len = it->GetSize() - offset;
+		++count;
+	}
+	return count;
+}
+
+// marks bytes as sent & releases fully sent chunks
+void Client::ConsumePending(size_t bytes) {
+	_pendingBytes -= std::min(bytes, _pendingBytes);
+	while (bytes > 0 && !_sendQueue.empty()) {
+		size_t available = _sendQueue.front().GetSize() - _sendOffset;
+		if (bytes < available) {
+			_sendOffset += bytes;
+			return;
+		}
+		bytes -= available;
+		_sendQueue.pop_front();
+		_sendOffset = 0;
+	}
+}
+
+// hands over the outbound chunks, used when the kernel may still read from them
+std::deque<SendBuffer> Client::TakeSendQueue() {
+	std::deque<SendBuffer> queue;
+	queue.swap(_sendQueue);
+	_sendOffset = 0;
+	_pendingBytes = 0;
+	return queue;
+}
+
+// returns if the poller waits for writability of this client
+bool Client::GetWriteArmed() const {
+	return _writeArmed;
+}
+
+// sets if the poller waits for writability of this client
+void Client::SetWriteArmed(bool writeArmed) {
+	_writeArmed = writeArmed;
+}
+
+// returns if the client is waiting for the end of iteration flush
+bool Client::GetFlushScheduled() const {
+	return _flushScheduled;
+}
+
+// sets if the client is waiting for the end of iteration flush
+void Client::SetFlushScheduled(bool flushScheduled) {
+	_flushScheduled = flushScheduled;
+}
+
+// returns the peer address in network byte order
+uint32_t Client::GetAddress() const {
+	return _address;
+}
+
+// sets the peer address in network byte order
+void Client::SetAddress(uint32_t address) {
+	_address = address;
+	char host[INET_ADDRSTRLEN];
+	struct in_addr addr;
+	addr.s_addr = address;
+	_host = inet_ntop(AF_INET, &addr, host, sizeof(host)) ? host : "unknown";
+	_renderPrefix();
+}
+
+// returns the peer address as text
+const std::string& Client::GetHost() const {
+	return _host;
+}
+
+// returns the nick!user@host source of the client's messages
+const std::string& Client::GetPrefix() const {
+	return _prefix;
+}
+
+// rebuilds the prefix, parts that are not known yet are left out
+void Client::_renderPrefix() {
+	_prefix = _nickName;
+	if (!_userName.empty()) {
+		_prefix += "!" + _userName;
+	}
+	if (!_host.empty()) {
+		_prefix += "@" + _host;
+	}
+}
+
+// returns if the client exceeded its sendq limit & is about to be closed
+bool Client::GetSendqExceeded() const {
+	return _sendqExceeded;
+}
+
+// sets if the client exceeded its sendq limit
+void Client::SetSendqExceeded(bool sendqExceeded) {
+	_sendqExceeded = sendqExceeded;
+}
+
+// returns the number of low priority lines dropped for this client
+size_t Client::GetDroppedMessages() const {
+	return _droppedMessages;
+}
+
+// counts a low priority line dropped for this client
+void Client::CountDroppedMessage() {
+	++_droppedMessages;
+}
+
+// returns if the client completed PASS, NICK & USER
+bool Client::GetRegistered() const {
+	return _registered;
+}
+
+// sets if the client completed PASS, NICK & USER
+void Client::SetRegistered(bool registered) {
+	_registered = registered;
+}
+
+// returns when the last line of the client was received
+uint64_t Client::GetLastActivity() const {
+	return _lastActivity;
+}
+
+// sets when the last line of the client was received
+void Client::SetLastActivity(uint64_t lastActivity) {
+	_lastActivity = lastActivity;
+}
+
+// returns when the outstanding keepalive PING was sent, 0 if there is none
+uint64_t Client::GetPingSentAt() const {
+	return _pingSentAt;
+}
+
+// sets when the outstanding keepalive PING was sent
+void Client::SetPingSentAt(uint64_t pingSentAt) {
+	_pingSentAt = pingSentAt;
+}
+
+// returns the last measured round trip time in milliseconds, -1 if unknown
+int64_t Client::GetRtt() const {
+	return _rtt;
+}
+
+// sets the last measured round trip time in milliseconds
+void Client::SetRtt(int64_t rtt) {
+	_rtt = rtt;
+}
+
+// returns the names of the channels the client is a member of
+const JoinedChannels& Client::GetChannels() const {
+	return _channels;
+}
+
+// returns if the client is a member of a channel
+bool Client::IsInChannel(const std::string &channelName) const {
+	return _channels.find(channelName) != _channels.end();
+}
+
+// records that the client joined a channel
+void Client::AddChannel(const std::string &channelName) {
+	_channels.insert(channelName);
+}
+
+// records that the client left a channel
+void Client::RemoveChannel(const std::string &channelName) {
+	_channels.erase(channelName);
+}
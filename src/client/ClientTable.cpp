@@ -0,0 +1,71 @@
+//
+// Created on 10/18/26.
+//
+
+#include "ClientTable.hpp"
+
+/* --------------------------------------------------------------------------------- */
+/* Constructors & Destructors                                                        */
+/* --------------------------------------------------------------------------------- */
+ClientTable::ClientTable() {}
+
+ClientTable::~ClientTable() {}
+
+/* --------------------------------------------------------------------------------- */
+/* Clients                                                                           */
+/* --------------------------------------------------------------------------------- */
+// stores the client of a newly accepted fd
+Client& ClientTable::Insert(int fd, const Client &client) {
+	if (static_cast<size_t>(fd) >= _slots.size()) {
+		// fds are handed out lowest first, doubling keeps resizes rare
+		size_t size = _slots.size() * 2 > static_cast<size_t>(fd) ? _slots.size() * 2 : fd + 1;
+		Slot unused = {Client(), 0, -1};
+		_slots.resize(size, unused);
+	}
+	Slot &slot = _slots[fd];
+	if (slot.livePos == -1) {
+		slot.livePos = static_cast<int>(_live.size());
+		_live.push_back(fd);
+	}
+	slot.client = client;
+	return slot.client;
+}
+
+// frees the slot of fd & invalidates every handle to its client
+void ClientTable::Erase(int fd) {
+	if (!Contains(fd)) {
+		return;
+	}
+	Slot &slot = _slots[fd];
+	// the last live fd takes the freed position
+	int last = _live.back();
+	_live[slot.livePos] = last;
+	_slots[last].livePos = slot.livePos;
+	_live.pop_back();
+	slot.livePos = -1;
+	++slot.generation;
+	// drop strings, queues & buffers now instead of on reuse
+	slot.client = Client();
+}
+
+// returns the number of clients
+size_t ClientTable::size() const {
+	return _live.size();
+}
+
+// returns the live fds
+const std::vector<int>& ClientTable::GetFds() const {
+	return _live;
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Handles                                                                           */
+/* --------------------------------------------------------------------------------- */
+// returns a handle to the client currently on fd
+ClientHandle ClientTable::GetHandle(int fd) const {
+	ClientHandle handle = {fd, 0};
+	if (fd >= 0 && static_cast<size_t>(fd) < _slots.size()) {
+		handle.generation = _slots[fd].generation;
+	}
+	return handle;
+}
@@ -0,0 +1,205 @@
+//
+// Created on 10/18/26.
+//
+
+#include "RecvBuffer.hpp"
+#include <cstring>
+#include <utility>
+
+/* --------------------------------------------------------------------------------- */
+/* Constructors & Destructors                                                        */
+/* --------------------------------------------------------------------------------- */
+RecvBuffer::RecvBuffer() : _pool(nullptr), _data(nullptr), _capacity(0), _readPos(0), _writePos(0), _scanPos(0),
+	_discarding(false) {}
+
+RecvBuffer::RecvBuffer(BufferPool *pool) : _pool(pool), _data(nullptr), _capacity(0), _readPos(0), _writePos(0),
+	_scanPos(0), _discarding(false) {}
+
+RecvBuffer::RecvBuffer(const RecvBuffer &other) : _pool(other._pool), _data(nullptr), _capacity(0), _readPos(0),
+	_writePos(0), _scanPos(0), _discarding(other._discarding) {
+	if (!other.Empty()) {
+		Append(other._data + other._readPos, other.GetSize());
+		_scanPos = other._scanPos - other._readPos;
+	}
+}
+
+RecvBuffer::RecvBuffer(RecvBuffer &&other) noexcept
+	: _pool(nullptr), _data(nullptr), _capacity(0), _readPos(0), _writePos(0), _scanPos(0),
+	_discarding(false) {
+	_swap(other);
+}
+
+RecvBuffer& RecvBuffer::operator=(RecvBuffer other) noexcept {
+	_swap(other);
+	return *this;
+}
+
+RecvBuffer::~RecvBuffer() {
+	_deallocate();
+}
+
+// exchanges the storage of two buffers
+void RecvBuffer::_swap(RecvBuffer &other) noexcept {
+	std::swap(_pool, other._pool);
+	std::swap(_data, other._data);
+	std::swap(_capacity, other._capacity);
+	std::swap(_readPos, other._readPos);
+	std::swap(_writePos, other._writePos);
+	std::swap(_scanPos, other._scanPos);
+	std::swap(_discarding, other._discarding);
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Storage                                                                           */
+/* --------------------------------------------------------------------------------- */
+// returns storage of the given capacity, a pool slab if it fits
+char* RecvBuffer::_allocate(size_t capacity) {
+	if (_pool && capacity == _pool->GetSlabSize()) {
+		return _pool->Acquire();
+	}
+	if (_pool) {
+		_pool->CountOversized(capacity);
+	}
+	return new char[capacity];
+}
+
+// gives the storage back to where it came from
+void RecvBuffer::_deallocate() {
+	if (!_data) {
+		return;
+	}
+	if (_pool && _capacity == _pool->GetSlabSize()) {
+		_pool->Release(_data);
+	} else {
+		if (_pool) {
+			_pool->UncountOversized(_capacity);
+		}
+		delete[] _data;
+	}
+	_data = nullptr;
+	_capacity = 0;
+}
+
+// hands the storage back once every received line was consumed
+void RecvBuffer::ReleaseIfEmpty() {
+	if (Empty()) {
+		_deallocate();
+		_readPos = 0;
+		_writePos = 0;
+		_scanPos = 0;
+	}
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Writing                                                                           */
+/* --------------------------------------------------------------------------------- */
+// returns room for at least minSpace bytes at the write cursor, compacts or grows if needed
+char* RecvBuffer::Reserve(size_t minSpace) {
+	if (_capacity - _writePos >= minSpace) {
+		return _data + _writePos;
+	}
+	size_t unread = _writePos - _readPos;
+	if (_readPos > 0 && _capacity - unread >= minSpace) {
+		// consumed lines left room at the front, move the partial line there
+		std::memmove(_data, _data + _readPos, unread);
+	} else {
+		size_t capacity = _capacity ? _capacity * 2 : (_pool ? _pool->GetSlabSize() : RECV_BUFFER_INITIAL_SIZE);
+		while (capacity - unread < minSpace) {
+			capacity *= 2;
+		}
+		char *data = _allocate(capacity);
+		if (unread > 0) {
+			std::memcpy(data, _data + _readPos, unread);
+		}
+		_deallocate();
+		_data = data;
+		_capacity = capacity;
+	}
+	_scanPos -= _readPos;
+	_writePos = unread;
+	_readPos = 0;
+	return _data + _writePos;
+}
+
+// returns how many bytes fit at the write cursor without another Reserve
+size_t RecvBuffer::GetWritableSize() const {
+	return _capacity - _writePos;
+}
+
+// marks bytes written at the write cursor as received
+void RecvBuffer::Commit(size_t bytes) {
+	_writePos += bytes;
+}
+
+// copies received bytes to the end of the buffer
+void RecvBuffer::Append(const char *data, size_t size) {
+	std::memcpy(Reserve(size), data, size);
+	Commit(size);
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Reading                                                                           */
+/* --------------------------------------------------------------------------------- */
+// pops the next CRLF or LF terminated line, the view stays valid until the next Reserve/Append
+LineStatus RecvBuffer::NextLine(std::string_view &line) {
+	while (true) {
+		// only look at bytes that were not scanned by an earlier call & never past the longest allowed line
+		size_t start = _scanPos > _readPos ? _scanPos : _readPos;
+		size_t limit = _writePos;
+		if (!_discarding && limit - _readPos > MAX_LINE_SIZE) {
+			limit = _readPos + MAX_LINE_SIZE;
+		}
+		size_t end = LineScanner::FindLineFeed(_data + start, limit - start);
+		if (end == std::string_view::npos) {
+			if (_discarding) {
+				_consume(_writePos);
+				return LINE_NONE;
+			}
+			if (_writePos - _readPos >= MAX_LINE_SIZE) {
+				// no terminator where one had to be, drop the line instead of growing the buffer
+				_discarding = true;
+				_consume(limit);
+				return LINE_TOO_LONG;
+			}
+			_scanPos = _writePos;
+			return LINE_NONE;
+		}
+		end += start;
+		if (_discarding) {
+			// the rest of an overlong line
+			_discarding = false;
+			_consume(end + 1);
+			continue;
+		}
+		line = std::string_view(_data + _readPos, LineScanner::GetLineLength(_data + _readPos, end - _readPos));
+		_consume(end + 1);
+		return LINE_OK;
+	}
+}
+
+// moves the read cursor to end
+void RecvBuffer::_consume(size_t end) {
+	_readPos = end;
+	_scanPos = end;
+	if (_readPos == _writePos) {
+		// drained, the next recv starts at the front again without moving anything
+		_readPos = 0;
+		_writePos = 0;
+		_scanPos = 0;
+	}
+}
+
+// returns if no unread bytes are left
+bool RecvBuffer::Empty() const {
+	return _readPos == _writePos;
+}
+
+// returns if input is dropped until the end of an overlong line
+bool RecvBuffer::IsDiscarding() const {
+	return _discarding;
+}
+
+// returns the number of unread bytes
+size_t RecvBuffer::GetSize() const {
+	return _writePos - _readPos;
+}
@@ -0,0 +1,91 @@
+//
+// Created on 10/18/26.
+//
+
+#include "SendBuffer.hpp"
+#include <cstring>
+#include <new>
+#include <utility>
+
+/* --------------------------------------------------------------------------------- */
+/* Constructors & Destructors                                                        */
+/* --------------------------------------------------------------------------------- */
+SendBuffer::SendBuffer() : _block(nullptr) {}
+
+SendBuffer::SendBuffer(std::string_view data, size_t capacity) : _block(nullptr) {
+	if (capacity < data.size()) {
+		capacity = data.size();
+	}
+	_block = static_cast<Block *>(::operator new(sizeof(Block) + capacity));
+	_block->refs = 1;
+	_block->size = data.size();
+	_block->capacity = capacity;
+	if (!data.empty()) {
+		std::memcpy(_bytes(), data.data(), data.size());
+	}
+}
+
+SendBuffer::SendBuffer(const SendBuffer &other) : _block(other._block) {
+	if (_block) {
+		++_block->refs;
+	}
+}
+
+SendBuffer::SendBuffer(SendBuffer &&other) noexcept : _block(other._block) {
+	other._block = nullptr;
+}
+
+SendBuffer& SendBuffer::operator=(SendBuffer other) noexcept {
+	std::swap(_block, other._block);
+	return *this;
+}
+
+SendBuffer::~SendBuffer() {
+	_release();
+}
+
+// drops this reference, the last one frees the block
+void SendBuffer::_release() {
+	if (_block && --_block->refs == 0) {
+		::operator delete(_block);
+	}
+	_block = nullptr;
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Bytes                                                                             */
+/* --------------------------------------------------------------------------------- */
+// returns the start of the bytes, right behind the header
+char* SendBuffer::_bytes() const {
+	return reinterpret_cast<char *>(_block + 1);
+}
+
+// returns the bytes of the block
+const char* SendBuffer::GetData() const {
+	return _block ? _bytes() : nullptr;
+}
+
+// returns the number of bytes in the block
+size_t SendBuffer::GetSize() const {
+	return _block ? _block->size : 0;
+}
+
+// returns how many bytes Append accepts, 0 while the block is shared
+size_t SendBuffer::GetSpace() const {
+	if (!_block || _block->refs > 1) {
+		return 0;
+	}
+	return _block->capacity - _block->size;
+}
+
+// appends bytes behind the existing ones, the caller checks GetSpace first
+void SendBuffer::Append(std::string_view data) {
+	std::memcpy(Extend(data.size()), data.data(), data.size());
+}
+
+// grows the block by size bytes & returns them for the caller to fill, the caller checks GetSpace first
+char* SendBuffer::Extend(size_t size) {
+	char *out = _bytes() + _block->size;
+	_block->size += size;
+	return out;
+}
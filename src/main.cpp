@@ -4,9 +4,99 @@
 
 #include "main.hpp"
 
+// parses the optional "--option value" pairs following port & password
+static ServerConfig parseOptions(int argc, char **argv) {
+	ServerConfig config;
+	for (int i = 3; i < argc; i += 2) {
+		std::string option = argv[i];
+		if (i + 1 >= argc) {
+			throw std::invalid_argument("Missing value for option " + option);
+		}
+		std::string value = argv[i + 1];
+		if (option == "--poller") {
+			if (value == "epoll") {
+				config.backend = POLLER_EPOLL;
+			} else if (value == "poll") {
+				config.backend = POLLER_POLL;
+			} else if (value == "uring") {
+				config.backend = POLLER_URING;
+			} else {
+				throw std::invalid_argument("Invalid option, expected --poller epoll|poll|uring");
+			}
+		} else if (option == "--threads") {
+			size_t threads = std::stoul(value);
+			if (threads < 1 || threads > MAX_THREADS) {
+				throw std::out_of_range("Thread count must be between 1 and " + std::to_string(MAX_THREADS));
+			}
+			config.threads = threads;
+		} else if (option == "--max-clients") {
+			config.maxClients = std::stoul(value);
+		} else if (option == "--max-per-ip") {
+			config.maxPerIp = std::stoul(value);
+		} else if (option == "--connect-rate") {
+			config.connectRate = std::stoul(value);
+		} else if (option == "--sendq-high") {
+			config.sendqHighWater = std::stoul(value);
+		} else if (option == "--sendq-max") {
+			config.sendqLimit = std::stoul(value);
+		} else if (option == "--ping-interval") {
+			config.pingInterval = std::stoul(value);
+		} else if (option == "--ping-timeout") {
+			config.pingTimeout = std::stoul(value);
+		} else if (option == "--register-timeout") {
+			config.registrationTimeout = std::stoul(value);
+		} else if (option == "--server-name") {
+			// a host name, anything else would break the prefix of the replies
+			bool valid = !value.empty() && std::all_of(value.begin(), value.end(), [](unsigned char c) {
+				return std::isalnum(c) || c == '.' || c == '-';
+			});
+			if (!valid) {
+				throw std::invalid_argument("Invalid option, --server-name takes letters, digits, '.' & '-'");
+			}
+			config.serverName = value;
+		} else if (option == "--history-bytes") {
+			// offsets into the history are 32 bit
+			config.historyBytes = std::stoul(value);
+			if (config.historyBytes > UINT32_MAX) {
+				throw std::out_of_range("--history-bytes must fit in 32 bits");
+			}
+		} else {
+			throw std::invalid_argument("Unknown option " + option);
+		}
+	}
+	if (config.sendqHighWater > config.sendqLimit) {
+		throw std::invalid_argument("--sendq-high must not be larger than --sendq-max");
+	}
+	return config;
+}
+
+// runs one event loop per thread, the calling thread runs shard 0
+static void runShards(std::vector<std::unique_ptr<Server> > &shards) {
+//	only the main thread handles SIGINT, workers inherit the blocked mask
+	sigset_t blocked;
+	sigset_t previous;
+	sigemptyset(&blocked);
+	sigaddset(&blocked, SIGINT);
+	pthread_sigmask(SIG_BLOCK, &blocked, &previous);
+	std::vector<std::thread> workers;
+	for (size_t i = 1; i < shards.size(); ++i) {
+		workers.emplace_back(&Server::Run, shards[i].get());
+	}
+	pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+
+	shards[0]->Run();
+	for (size_t i = 0; i < workers.size(); ++i) {
+		workers[i].join();
+	}
+}
+
 int main(int argc, char **argv) {
-	if (argc != 3) {
-		std::cerr << "usage: ./ircserv <port> <password>" << std::endl;
+	if (argc < 3 || argc % 2 == 0) {
+		std::cerr << "usage: ./ircserv <port> <password> [--poller epoll|poll|uring] [--threads N]"
+			<< " [--max-clients N] [--max-per-ip N] [--connect-rate N]"
+			<< " [--sendq-high BYTES] [--sendq-max BYTES]"
+			<< " [--ping-interval S] [--ping-timeout S] [--register-timeout S] [--server-name NAME]"
+			<< " [--history-bytes BYTES]" << std::endl;
 		return 1;
 	}
 
@@ -23,17 +113,26 @@ int main(int argc, char **argv) {
 			throw std::invalid_argument("Password cannot be empty");
 		}
 
-//		create server instance & set up signal handling
-		Server server(port, password);
-		Server::SetInstance(&server);
+//		get optional settings, io_uring falls back to epoll & epoll to poll where unavailable
+		ServerConfig config = parseOptions(argc, argv);
+
+//		create one server instance per event loop & set up signal handling
+		ShardBus bus(config.threads, config.historyBytes);
+		std::vector<std::unique_ptr<Server> > shards;
+		for (size_t i = 0; i < config.threads; ++i) {
+			shards.emplace_back(new Server(port, password, config, config.threads > 1 ? &bus : nullptr, i));
+		}
+		Server::SetInstance(shards[0].get());
 		signal(SIGINT, Server::SignalHandler);
+//		a peer closing its socket must surface as a send error, not kill the server
+		signal(SIGPIPE, SIG_IGN);
 
 //		run server
-		server.Run();
+		runShards(shards);
 	} catch (std::exception &e) {
 		std::cerr << e.what() << std::endl;
 		return 1;
 	}
 
 	return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,29 @@
+//
+// Created on 10/18/26.
+//
+
+#include "CaseMapping.hpp"
+
+// returns if two names are equal under the casemapping
+bool CaseMapping::Equals(std::string_view a, std::string_view b) {
+	if (a.size() != b.size()) {
+		return false;
+	}
+	for (size_t i = 0; i < a.size(); ++i) {
+		if (Fold(a[i]) != Fold(b[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// returns the FNV-1a hash of the folded name
+size_t CaseMapping::Hash(std::string_view name) {
+	uint64_t hash = 14695981039346656037ULL;
+	for (char c : name) {
+		hash ^= static_cast<unsigned char>(Fold(c));
+		hash *= 1099511628211ULL;
+	}
+	return static_cast<size_t>(hash);
+}
+
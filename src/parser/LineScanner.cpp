@@ -0,0 +1,105 @@
+//
+// Created on 10/18/26.
+//
+
+#include "LineScanner.hpp"
+#include <string_view>
+
+#if defined(__x86_64__) || defined(__i386__)
+# include <immintrin.h>
+# define LINE_SCANNER_X86
+#endif
+
+/* --------------------------------------------------------------------------------- */
+/* Variants                                                                          */
+/* --------------------------------------------------------------------------------- */
+// returns the offset of the first LF from pos on, one byte at a time
+static size_t findLineFeedScalar(const char *data, size_t size, size_t pos) {
+	for (; pos < size; ++pos) {
+		if (data[pos] == '\n') {
+			return pos;
+		}
+	}
+	return std::string_view::npos;
+}
+
+#ifdef LINE_SCANNER_X86
+// returns the offset of the first LF, 16 bytes per compare
+__attribute__((target("sse2")))
+static size_t findLineFeedSse2(const char *data, size_t size) {
+	const __m128i lf = _mm_set1_epi8('\n');
+	size_t pos = 0;
+	for (; pos + 16 <= size; pos += 16) {
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos));
+		unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, lf)));
+		if (mask) {
+			return pos + __builtin_ctz(mask);
+		}
+	}
+	return findLineFeedScalar(data, size, pos);
+}
+
+// returns the offset of the first LF, 32 bytes per compare
+__attribute__((target("avx2")))
+static size_t findLineFeedAvx2(const char *data, size_t size) {
+	const __m256i lf = _mm256_set1_epi8('\n');
+	size_t pos = 0;
+	for (; pos + 32 <= size; pos += 32) {
+		__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + pos));
+		unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, lf)));
+		if (mask) {
+			return pos + __builtin_ctz(mask);
+		}
+	}
+	return findLineFeedScalar(data, size, pos);
+}
+#endif
+
+// returns the offset of the first LF, for targets without a vector variant
+static size_t findLineFeedPortable(const char *data, size_t size) {
+	return findLineFeedScalar(data, size, 0);
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Dispatch                                                                          */
+/* --------------------------------------------------------------------------------- */
+typedef size_t (*FindLineFeedFunction)(const char *, size_t);
+
+struct ScannerVariant {
+	FindLineFeedFunction find;
+	const char *name;
+};
+
+// picks the widest variant the CPU supports
+static ScannerVariant selectVariant() {
+#ifdef LINE_SCANNER_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		return ScannerVariant{findLineFeedAvx2, "avx2"};
+	}
+	if (__builtin_cpu_supports("sse2")) {
+		return ScannerVariant{findLineFeedSse2, "sse2"};
+	}
+#endif
+	return ScannerVariant{findLineFeedPortable, "scalar"};
+}
+
+static const ScannerVariant scannerVariant = selectVariant();
+
+/* --------------------------------------------------------------------------------- */
+/* Scanning                                                                          */
+/* --------------------------------------------------------------------------------- */
+// returns the offset of the first LF in data, npos if there is none
+size_t LineScanner::FindLineFeed(const char *data, size_t size) {
+	return scannerVariant.find(data, size);
+}
+
+// returns the length of the line terminated by the LF at offset lf, without a trailing CR
+size_t LineScanner::GetLineLength(const char *data, size_t lf) {
+	return (lf > 0 && data[lf - 1] == '\r') ? lf - 1 : lf;
+}
+
+// returns the name of the variant in use
+const char* LineScanner::GetVariant() {
+	return scannerVariant.name;
+}
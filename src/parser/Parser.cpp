@@ -1,5 +1,4 @@
 #include "Parser.hpp"
-#include <iostream>
 
 Parser::Parser() {
 
@@ -9,55 +8,132 @@ Parser::~Parser() {
 
 }
 
-std::tuple<Method, std::vector<std::string>> Parser::parse(const std::string &msg) const {
-	std::vector<std::string> tokens;
-	std::istringstream tokenStream(msg);
-	std::string token;
+// returns the next space separated word of line starting at pos & moves pos past it
+static std::string_view nextWord(std::string_view line, size_t &pos) {
+	size_t end = line.find(' ', pos);
+	if (end == std::string_view::npos) {
+		end = line.size();
+	}
+	std::string_view word = line.substr(pos, end - pos);
+	pos = end;
+	return word;
+}
+
+// skips the spaces at pos, RFC 2812 allows one but clients send more
+static void skipSpaces(std::string_view line, size_t &pos) {
+	while (pos < line.size() && line[pos] == ' ') {
+		++pos;
+	}
+}
+
+// message = [ ":" prefix SPACE ] command [ params ], params = *14( SPACE middle ) [ SPACE ":" trailing ]
+ParseResult Parser::Parse(std::string_view line, MessageView &msg) const {
+	msg.method = INVALID;
+	msg.prefix = std::string_view();
+	msg.command = std::string_view();
+	msg.paramCount = 0;
+	if (line.size() > MAX_LINE_LENGTH) {
+		return PARSE_TOO_LONG;
+	}
+
+	size_t pos = 0;
+	skipSpaces(line, pos);
+	if (pos < line.size() && line[pos] == ':') {
+		++pos;
+		msg.prefix = nextWord(line, pos);
+		skipSpaces(line, pos);
+	}
+	if (pos >= line.size()) {
+		return PARSE_EMPTY;
+	}
+	msg.command = nextWord(line, pos);
 
-	// Split on whitespace, except if token starts with ':'
-	while (tokenStream >> token) {
-		if (!token.empty() && token[0] == ':') {
-			// Everything else goes into one trailing token
-			std::string trailingParam = token.substr(1);
-			std::string rest;
-			std::getline(tokenStream, rest);
-			if (!rest.empty())
-				trailingParam += rest;
-			tokens.push_back(trailingParam);
+	while (true) {
+		skipSpaces(line, pos);
+		if (pos >= line.size()) {
+			break;
+		}
+		if (line[pos] == ':' || msg.paramCount == MAX_PARAMS - 1) {
+			// trailing, keeps its spaces, the colon is optional for the 15th parameter
+			if (line[pos] == ':') {
+				++pos;
+			}
+			msg.params[msg.paramCount++] = line.substr(pos);
 			break;
 		}
-		tokens.push_back(token);
-	}
-
-	// std::cout << "Tokens: ";
-	// for (const std::string &t : tokens) {
-	// 	std::cout << t << " ";
-	// }
-	// std::cout << std::endl;
-	// Determine the command
-	Method method = INVALID;
-	if (!tokens.empty()) {
-		std::string command = tokens[0];
-		std::transform(command.begin(), command.end(), command.begin(), ::toupper);
-		if (command == "PASS")     method = AUTHENTICATE;
-		else if (command == "NICK") method = NICK;
-		else if (command == "USER") method = USER;
-		else if (command == "JOIN") method = JOIN;
-		else if (command == "PRIVMSG") method = MSG;
-		else if (command == "KICK") method = KICK;
-		else if (command == "INVITE") method = INVITE;
-		else if (command == "TOPIC")  method = TOPIC;
-		else if (command == "MODE")   method = MODE;
-		else if (command == "PING")   method = PING;
-		else if (command == "QUIT")   method = QUIT;
-		else                          method = INVALID;
-	}
-	// std::cout << "Method: " << method << std::endl;
-
-	// Remove the first token (the command) to leave only parameters
-	std::vector<std::string> params;
-	if (tokens.size() > 0) {
-		params.assign(tokens.begin() + 1, tokens.end());
-	}
-	return std::make_tuple(method, params);
+		msg.params[msg.paramCount++] = nextWord(line, pos);
+	}
+
+	msg.method = _lookupMethod(msg.command);
+	return PARSE_OK;
+}
+
+// upper cases an ASCII letter
+static char toUpper(char c) {
+	return (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c;
+}
+
+// returns if a command matches an upper case name of the same length regardless of its case
+static bool equalsCommand(std::string_view command, const char *name) {
+	for (size_t i = 0; i < command.size(); ++i) {
+		if (toUpper(command[i]) != name[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// returns method if command is name, INVALID otherwise
+static Method matchCommand(std::string_view command, const char *name, Method method) {
+	return equalsCommand(command, name) ? method : INVALID;
+}
+
+// maps a command name to its method with a switch on length & first letter, a single compare decides
+// add new commands to the case of their length & first letter
+Method Parser::_lookupMethod(std::string_view command) {
+	if (command.empty()) {
+		return INVALID;
+	}
+	char first = toUpper(command[0]);
+	switch (command.size()) {
+		case 4:
+			switch (first) {
+				case 'J': return matchCommand(command, "JOIN", JOIN);
+				case 'K': return matchCommand(command, "KICK", KICK);
+				case 'M': return matchCommand(command, "MODE", MODE);
+				case 'N': return matchCommand(command, "NICK", NICK);
+				case 'Q': return matchCommand(command, "QUIT", QUIT);
+				case 'U': return matchCommand(command, "USER", USER);
+				case 'P':
+					switch (toUpper(command[1])) {
+						case 'A': return matchCommand(command, "PASS", AUTHENTICATE);
+						case 'I': return matchCommand(command, "PING", PING);
+						case 'O': return matchCommand(command, "PONG", PONG);
+					}
+					break;
+			}
+			break;
+		case 5:
+			switch (first) {
+				case 'S': return matchCommand(command, "STATS", STATS);
+				case 'T': return matchCommand(command, "TOPIC", TOPIC);
+			}
+			break;
+		case 6:
+			switch (first) {
+				case 'I': return matchCommand(command, "INVITE", INVITE);
+			}
+			break;
+		case 7:
+			switch (first) {
+				case 'P': return matchCommand(command, "PRIVMSG", MSG);
+			}
+			break;
+		case 11:
+			switch (first) {
+				case 'C': return matchCommand(command, "CHATHISTORY", CHATHISTORY);
+			}
+			break;
+	}
+	return INVALID;
 }
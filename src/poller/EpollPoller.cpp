@@ -0,0 +1,104 @@
+//
+// Created on 10/18/26.
+//
+
+#include "EpollPoller.hpp"
+
+#ifdef __linux__
+# include <unistd.h>
+# include <stdexcept>
+
+/* --------------------------------------------------------------------------------- */
+/* Constructors & Destructors                                                        */
+/* --------------------------------------------------------------------------------- */
+EpollPoller::EpollPoller() : _epollEvents(MAX_POLLER_EVENTS) {
+	_epollFd = epoll_create1(EPOLL_CLOEXEC);
+	if (_epollFd == -1) {
+		throw std::runtime_error("Failed to create epoll instance");
+	}
+}
+
+EpollPoller::~EpollPoller() {
+	close(_epollFd);
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Registration                                                                      */
+/* --------------------------------------------------------------------------------- */
+// translates poller flags into an epoll event
+static epoll_event _toEpollEvent(int fd, uint32_t events, bool edgeTriggered) {
+	epoll_event ev;
+	ev.events = EPOLLRDHUP;
+	if (events & POLLER_READ) {
+		ev.events |= EPOLLIN;
+	}
+	if (events & POLLER_WRITE) {
+		ev.events |= EPOLLOUT;
+	}
+	if (edgeTriggered) {
+		ev.events |= EPOLLET;
+	}
+	ev.data.fd = fd;
+	return ev;
+}
+
+// registers a fd with the epoll instance
+bool EpollPoller::Add(int fd, uint32_t events, bool edgeTriggered) {
+	if (fd < 0) {
+		return false;
+	}
+	if (static_cast<size_t>(fd) >= _edgeTriggered.size()) {
+		_edgeTriggered.resize(fd + 1, false);
+	}
+	_edgeTriggered[fd] = edgeTriggered;
+	epoll_event ev = _toEpollEvent(fd, events, edgeTriggered);
+	return epoll_ctl(_epollFd, EPOLL_CTL_ADD, fd, &ev) == 0;
+}
+
+// changes the events a registered fd is interested in
+bool EpollPoller::Modify(int fd, uint32_t events) {
+	if (fd < 0 || static_cast<size_t>(fd) >= _edgeTriggered.size()) {
+		return false;
+	}
+	epoll_event ev = _toEpollEvent(fd, events, _edgeTriggered[fd]);
+	return epoll_ctl(_epollFd, EPOLL_CTL_MOD, fd, &ev) == 0;
+}
+
+// unregisters a fd, must be called before the fd is closed
+void EpollPoller::Remove(int fd) {
+	epoll_ctl(_epollFd, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Wait                                                                              */
+/* --------------------------------------------------------------------------------- */
+// waits for readiness, only ready fds are returned
+int EpollPoller::Wait(std::vector<PollerEvent>& events, int timeoutMs) {
+	events.clear();
+	int readyCount = epoll_wait(_epollFd, _epollEvents.data(), static_cast<int>(_epollEvents.size()), timeoutMs);
+	if (readyCount <= 0) {
+		return readyCount;
+	}
+	for (int i = 0; i < readyCount; ++i) {
+		PollerEvent event;
+		event.fd = _epollEvents[i].data.fd;
+		event.events = 0;
+		if (_epollEvents[i].events & EPOLLIN) {
+			event.events |= POLLER_READ;
+		}
+		if (_epollEvents[i].events & EPOLLOUT) {
+			event.events |= POLLER_WRITE;
+		}
+		if (_epollEvents[i].events & (EPOLLHUP | EPOLLERR | EPOLLRDHUP)) {
+			event.events |= POLLER_CLOSE;
+		}
+		events.push_back(event);
+	}
+	return readyCount;
+}
+
+const char* EpollPoller::GetName() const {
+	return "epoll";
+}
+
+#endif //__linux__
@@ -0,0 +1,321 @@
+//
+// Created on 10/18/26.
+//
+
+#include "IoUring.hpp"
+
+#ifdef IRC_HAS_IO_URING
+# include <sys/mman.h>
+# include <sys/socket.h>
+# include <sys/syscall.h>
+# include <poll.h>
+# include <unistd.h>
+# include <cerrno>
+# include <cstring>
+# include <stdexcept>
+
+/* --------------------------------------------------------------------------------- */
+/* Constructors & Destructors                                                        */
+/* --------------------------------------------------------------------------------- */
+IoUring::IoUring() : _ringFd(-1), _ringMemory(MAP_FAILED), _ringMemorySize(0), _sqes(static_cast<io_uring_sqe *>(MAP_FAILED)),
+	_sqesSize(0), _sqLocalTail(0), _bufRing(static_cast<io_uring_buf_ring *>(MAP_FAILED)), _bufRingSize(0),
+	_buffers(nullptr), _bufTail(0) {
+	struct io_uring_params params;
+	std::memset(&params, 0, sizeof(params));
+	params.flags = IORING_SETUP_CQSIZE;
+	params.cq_entries = URING_QUEUE_DEPTH * 4;
+	_ringFd = static_cast<int>(syscall(__NR_io_uring_setup, URING_QUEUE_DEPTH, &params));
+	if (_ringFd < 0) {
+		throw std::runtime_error("io_uring is not available");
+	}
+	unsigned required = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG | IORING_FEAT_FAST_POLL;
+	if ((params.features & required) != required) {
+		_release();
+		throw std::runtime_error("io_uring is missing required features");
+	}
+
+//	map the shared submission/completion rings & the submission entries
+	size_t sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	size_t cqSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	_ringMemorySize = sqSize > cqSize ? sqSize : cqSize;
+	_ringMemory = mmap(nullptr, _ringMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ringFd,
+		IORING_OFF_SQ_RING);
+	_sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+	_sqes = static_cast<io_uring_sqe *>(mmap(nullptr, _sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+		_ringFd, IORING_OFF_SQES));
+	if (_ringMemory == MAP_FAILED || _sqes == MAP_FAILED) {
+		_release();
+		throw std::runtime_error("Failed to map io_uring rings");
+	}
+
+	char *ring = static_cast<char *>(_ringMemory);
+	_sqHead = reinterpret_cast<unsigned *>(ring + params.sq_off.head);
+	_sqTail = reinterpret_cast<unsigned *>(ring + params.sq_off.tail);
+	_sqArray = reinterpret_cast<unsigned *>(ring + params.sq_off.array);
+	_sqMask = *reinterpret_cast<unsigned *>(ring + params.sq_off.ring_mask);
+	_sqEntries = params.sq_entries;
+	_sqLocalTail = *_sqTail;
+	_cqHead = reinterpret_cast<unsigned *>(ring + params.cq_off.head);
+	_cqTail = reinterpret_cast<unsigned *>(ring + params.cq_off.tail);
+	_cqMask = *reinterpret_cast<unsigned *>(ring + params.cq_off.ring_mask);
+	_cqes = reinterpret_cast<io_uring_cqe *>(ring + params.cq_off.cqes);
+
+	try {
+		_setupBufferRing();
+		_probeMultishotRecv();
+	} catch (std::exception &) {
+		_release();
+		throw;
+	}
+}
+
+IoUring::~IoUring() {
+	_release();
+}
+
+// unmaps & closes everything that was set up
+void IoUring::_release() {
+	if (_bufRing != MAP_FAILED) {
+		munmap(_bufRing, _bufRingSize);
+		_bufRing = static_cast<io_uring_buf_ring *>(MAP_FAILED);
+	}
+	delete[] _buffers;
+	_buffers = nullptr;
+	if (_sqes != MAP_FAILED) {
+		munmap(_sqes, _sqesSize);
+		_sqes = static_cast<io_uring_sqe *>(MAP_FAILED);
+	}
+	if (_ringMemory != MAP_FAILED) {
+		munmap(_ringMemory, _ringMemorySize);
+		_ringMemory = MAP_FAILED;
+	}
+	if (_ringFd >= 0) {
+		close(_ringFd);
+		_ringFd = -1;
+	}
+}
+
+// registers the provided buffer ring multishot recv picks its buffers from
+void IoUring::_setupBufferRing() {
+	_bufRingSize = URING_BUFFER_COUNT * sizeof(struct io_uring_buf);
+	_bufRing = static_cast<io_uring_buf_ring *>(mmap(nullptr, _bufRingSize, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+	if (_bufRing == MAP_FAILED) {
+		throw std::runtime_error("Failed to allocate io_uring buffer ring");
+	}
+	struct io_uring_buf_reg reg;
+	std::memset(&reg, 0, sizeof(reg));
+	reg.ring_addr = reinterpret_cast<uint64_t>(_bufRing);
+	reg.ring_entries = URING_BUFFER_COUNT;
+	reg.bgid = URING_BUFFER_GROUP;
+	if (syscall(__NR_io_uring_register, _ringFd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+		throw std::runtime_error("io_uring provided buffer rings are not supported");
+	}
+	_buffers = new char[URING_BUFFER_COUNT * URING_BUFFER_SIZE];
+	for (uint16_t i = 0; i < URING_BUFFER_COUNT; ++i) {
+		RecycleBuffer(i);
+	}
+}
+
+// multishot recv is newer than everything checked so far, try it on a socketpair
+void IoUring::_probeMultishotRecv() {
+	int pair[2];
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) == -1) {
+		throw std::runtime_error("Failed to create io_uring probe socket");
+	}
+	PrepareMultishotRecv(pair[0], 0);
+	char byte = 0;
+	ssize_t written = write(pair[1], &byte, 1);
+	std::vector<IoCompletion> completions;
+	int supported = -1;
+	for (int attempt = 0; written == 1 && supported == -1 && attempt < 10; ++attempt) {
+		if (SubmitAndWait(completions, 100) < 0) {
+			break;
+		}
+		for (size_t i = 0; i < completions.size(); ++i) {
+			uint16_t bufferId;
+			if (HasBuffer(completions[i].flags, bufferId)) {
+				RecycleBuffer(bufferId);
+			}
+			supported = (completions[i].res > 0 && HasMore(completions[i].flags)) ? 1 : 0;
+		}
+	}
+	CancelFd(pair[0], 0);
+	close(pair[0]);
+	close(pair[1]);
+	if (supported != 1) {
+		throw std::runtime_error("io_uring multishot recv is not supported");
+	}
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Submission                                                                        */
+/* --------------------------------------------------------------------------------- */
+// wraps io_uring_enter
+int IoUring::_enter(unsigned toSubmit, unsigned minComplete, unsigned flags, void *arg, size_t argSize) {
+	__atomic_store_n(_sqTail, _sqLocalTail, __ATOMIC_RELEASE);
+	return static_cast<int>(syscall(__NR_io_uring_enter, _ringFd, toSubmit, minComplete, flags, arg, argSize));
+}
+
+// makes sure count entries can be prepared without an implicit submit in between
+void IoUring::ReserveSubmissions(unsigned count) {
+	unsigned pending = _sqLocalTail - __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE);
+	if (_sqEntries - pending < count) {
+		_enter(pending, 0, 0, nullptr, 0);
+	}
+}
+
+// returns the next free, zeroed submission entry
+struct io_uring_sqe* IoUring::_getSqe() {
+	ReserveSubmissions(1);
+	unsigned index = _sqLocalTail & _sqMask;
+	struct io_uring_sqe *sqe = &_sqes[index];
+	std::memset(sqe, 0, sizeof(*sqe));
+	_sqArray[index] = index;
+	++_sqLocalTail;
+	return sqe;
+}
+
+// accepts connections until cancelled
+void IoUring::PrepareMultishotAccept(int fd, uint64_t userData) {
+	struct io_uring_sqe *sqe = _getSqe();
+	sqe->opcode = IORING_OP_ACCEPT;
+	sqe->fd = fd;
+	sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+	sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+	sqe->user_data = userData;
+}
+
+// receives into provided buffers until cancelled or out of buffers
+void IoUring::PrepareMultishotRecv(int fd, uint64_t userData) {
+	struct io_uring_sqe *sqe = _getSqe();
+	sqe->opcode = IORING_OP_RECV;
+	sqe->fd = fd;
+	sqe->ioprio = IORING_RECV_MULTISHOT;
+	sqe->flags = IOSQE_BUFFER_SELECT;
+	sqe->buf_group = URING_BUFFER_GROUP;
+	sqe->user_data = userData;
+}
+
+// reports readability until cancelled
+void IoUring::PrepareMultishotPoll(int fd, uint64_t userData) {
+	struct io_uring_sqe *sqe = _getSqe();
+	sqe->opcode = IORING_OP_POLL_ADD;
+	sqe->fd = fd;
+	sqe->poll32_events = POLLIN;
+	sqe->len = IORING_POLL_ADD_MULTI;
+	sqe->user_data = userData;
+}
+
+// sends a buffer, linked sends run strictly in order
+void IoUring::PrepareSend(int fd, const void *data, size_t size, bool linkNext, uint64_t userData) {
+	struct io_uring_sqe *sqe = _getSqe();
+	sqe->opcode = IORING_OP_SEND;
+	sqe->fd = fd;
+	sqe->addr = reinterpret_cast<uint64_t>(data);
+	sqe->len = static_cast<uint32_t>(size);
+	sqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL;
+	sqe->flags = linkNext ? IOSQE_IO_LINK : 0;
+	sqe->user_data = userData;
+}
+
+// cancels every request on a fd & submits right away
+void IoUring::CancelFd(int fd, uint64_t userData) {
+	struct io_uring_sqe *sqe = _getSqe();
+	sqe->opcode = IORING_OP_ASYNC_CANCEL;
+	sqe->fd = fd;
+	sqe->cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+	sqe->user_data = userData;
+	_enter(_sqLocalTail - __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE), 0, 0, nullptr, 0);
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Completion                                                                        */
+/* --------------------------------------------------------------------------------- */
+// submits everything prepared & collects completions, waits only if none are ready yet
+int IoUring::SubmitAndWait(std::vector<IoCompletion> &completions, int timeoutMs) {
+	completions.clear();
+	unsigned toSubmit = _sqLocalTail - __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE);
+	bool ready = *_cqHead != __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE);
+	if (!ready) {
+		struct __kernel_timespec timeout;
+		timeout.tv_sec = timeoutMs / 1000;
+		timeout.tv_nsec = static_cast<long long>(timeoutMs % 1000) * 1000000;
+		struct io_uring_getevents_arg arg;
+		std::memset(&arg, 0, sizeof(arg));
+		arg.ts = (timeoutMs >= 0) ? reinterpret_cast<uint64_t>(&timeout) : 0;
+		int ret = _enter(toSubmit, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+		if (ret < 0 && errno != ETIME && errno != EINTR) {
+			return -1;
+		}
+	} else if (toSubmit > 0) {
+		_enter(toSubmit, 0, 0, nullptr, 0);
+	}
+
+	unsigned head = *_cqHead;
+	unsigned tail = __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE);
+	for (; head != tail; ++head) {
+		const struct io_uring_cqe &cqe = _cqes[head & _cqMask];
+		IoCompletion completion;
+		completion.userData = cqe.user_data;
+		completion.res = cqe.res;
+		completion.flags = cqe.flags;
+		completions.push_back(completion);
+	}
+	__atomic_store_n(_cqHead, head, __ATOMIC_RELEASE);
+	return static_cast<int>(completions.size());
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Provided Buffers                                                                  */
+/* --------------------------------------------------------------------------------- */
+// returns the memory of a provided buffer
+const char* IoUring::GetBuffer(uint16_t bufferId) const {
+	return _buffers + static_cast<size_t>(bufferId) * URING_BUFFER_SIZE;
+}
+
+// hands a provided buffer back to the kernel
+void IoUring::RecycleBuffer(uint16_t bufferId) {
+	// the ring is an array of io_uring_buf, the flexible bufs member sits at the wrong offset in C++
+	struct io_uring_buf *buf = reinterpret_cast<io_uring_buf *>(_bufRing) + (_bufTail & (URING_BUFFER_COUNT - 1));
+	buf->addr = reinterpret_cast<uint64_t>(_buffers + static_cast<size_t>(bufferId) * URING_BUFFER_SIZE);
+	buf->len = URING_BUFFER_SIZE;
+	buf->bid = bufferId;
+	++_bufTail;
+	__atomic_store_n(&_bufRing->tail, static_cast<uint16_t>(_bufTail), __ATOMIC_RELEASE);
+}
+
+// returns if a multishot request stays armed after this completion
+bool IoUring::HasMore(uint32_t flags) {
+	return flags & IORING_CQE_F_MORE;
+}
+
+// returns if a completion carries a provided buffer & which one
+bool IoUring::HasBuffer(uint32_t flags, uint16_t &bufferId) {
+	if (!(flags & IORING_CQE_F_BUFFER)) {
+		return false;
+	}
+	bufferId = static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT);
+	return true;
+}
+
+#else
+# include <stdexcept>
+
+IoUring::IoUring() {
+	throw std::runtime_error("io_uring is not available on this platform");
+}
+
+void IoUring::PrepareMultishotAccept(int, uint64_t) {}
+void IoUring::PrepareMultishotRecv(int, uint64_t) {}
+void IoUring::PrepareMultishotPoll(int, uint64_t) {}
+void IoUring::PrepareSend(int, const void *, size_t, bool, uint64_t) {}
+void IoUring::ReserveSubmissions(unsigned) {}
+void IoUring::CancelFd(int, uint64_t) {}
+int IoUring::SubmitAndWait(std::vector<IoCompletion> &, int) { return -1; }
+const char* IoUring::GetBuffer(uint16_t) const { return nullptr; }
+void IoUring::RecycleBuffer(uint16_t) {}
+bool IoUring::HasMore(uint32_t) { return false; }
+bool IoUring::HasBuffer(uint32_t, uint16_t &) { return false; }
+
+#endif //IRC_HAS_IO_URING
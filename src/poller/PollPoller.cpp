@@ -0,0 +1,102 @@
+//
+// Created on 10/18/26.
+//
+
+#include "PollPoller.hpp"
+
+/* --------------------------------------------------------------------------------- */
+/* Constructors & Destructors                                                        */
+/* --------------------------------------------------------------------------------- */
+PollPoller::PollPoller() {}
+
+PollPoller::~PollPoller() {}
+
+/* --------------------------------------------------------------------------------- */
+/* Registration                                                                      */
+/* --------------------------------------------------------------------------------- */
+// registers a fd, poll is always level triggered
+bool PollPoller::Add(int fd, uint32_t events, bool /*edgeTriggered*/) {
+	if (fd < 0) {
+		return false;
+	}
+	if (static_cast<size_t>(fd) >= _slots.size()) {
+		_slots.resize(fd + 1, -1);
+	}
+	if (_slots[fd] != -1) {
+		return Modify(fd, events);
+	}
+	struct pollfd pfd;
+	pfd.fd = fd;
+	pfd.events = 0;
+	pfd.revents = 0;
+	_slots[fd] = static_cast<int>(_pollFds.size());
+	_pollFds.push_back(pfd);
+	return Modify(fd, events);
+}
+
+// changes the events a registered fd is interested in
+bool PollPoller::Modify(int fd, uint32_t events) {
+	if (fd < 0 || static_cast<size_t>(fd) >= _slots.size() || _slots[fd] == -1) {
+		return false;
+	}
+	short pollEvents = 0;
+	if (events & POLLER_READ) {
+		pollEvents |= POLLIN;
+	}
+	if (events & POLLER_WRITE) {
+		pollEvents |= POLLOUT;
+	}
+	_pollFds[_slots[fd]].events = pollEvents;
+	return true;
+}
+
+// unregisters a fd by swapping the last slot into its place
+void PollPoller::Remove(int fd) {
+	if (fd < 0 || static_cast<size_t>(fd) >= _slots.size() || _slots[fd] == -1) {
+		return;
+	}
+	int slot = _slots[fd];
+	int last = static_cast<int>(_pollFds.size()) - 1;
+	if (slot != last) {
+		_pollFds[slot] = _pollFds[last];
+		_slots[_pollFds[slot].fd] = slot;
+	}
+	_pollFds.pop_back();
+	_slots[fd] = -1;
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Wait                                                                              */
+/* --------------------------------------------------------------------------------- */
+// polls all registered fds & collects the ready ones
+int PollPoller::Wait(std::vector<PollerEvent>& events, int timeoutMs) {
+	events.clear();
+	int pollCount = poll(_pollFds.data(), _pollFds.size(), timeoutMs);
+	if (pollCount <= 0) {
+		return pollCount;
+	}
+	for (size_t i = 0; i < _pollFds.size() && events.size() < static_cast<size_t>(pollCount); ++i) {
+		short revents = _pollFds[i].revents;
+		if (revents == 0) {
+			continue;
+		}
+		PollerEvent event;
+		event.fd = _pollFds[i].fd;
+		event.events = 0;
+		if (revents & POLLIN) {
+			event.events |= POLLER_READ;
+		}
+		if (revents & POLLOUT) {
+			event.events |= POLLER_WRITE;
+		}
+		if (revents & (POLLHUP | POLLERR | POLLNVAL)) {
+			event.events |= POLLER_CLOSE;
+		}
+		events.push_back(event);
+	}
+	return static_cast<int>(events.size());
+}
+
+const char* PollPoller::GetName() const {
+	return "poll";
+}
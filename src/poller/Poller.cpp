@@ -0,0 +1,27 @@
+//
+// Created on 10/18/26.
+//
+
+#include "Poller.hpp"
+#include "PollPoller.hpp"
+#include "EpollPoller.hpp"
+#include <stdexcept>
+#include <iostream>
+
+Poller::~Poller() {}
+
+// creates the requested backend, falls back to poll if it is unavailable
+Poller* Poller::Create(PollerBackend backend) {
+#ifdef __linux__
+	if (backend == POLLER_EPOLL) {
+		try {
+			return new EpollPoller();
+		} catch (std::exception &e) {
+			std::cerr << e.what() << ", falling back to poll" << std::endl;
+		}
+	}
+#else
+	(void)backend;
+#endif
+	return new PollPoller();
+}
@@ -0,0 +1,144 @@
+//
+// Created on 10/18/26.
+//
+
+#include "Replies.hpp"
+#include <cstring>
+
+// text of a numeric after its target, {n} stands for the nth parameter
+struct ReplyFormat {
+	Numeric numeric;
+	const char *format;
+};
+
+static const ReplyFormat replyFormats[] = {
+	{RPL_WELCOME, ":Welcome to the Internet Relay Network {0}"},
+	{RPL_STATSLINKINFO, "{0} {1} {2} {3} {4} :sendq bytes, dropped lines, rtt ms, idle seconds"},
+	{RPL_ENDOFSTATS, "{0} :End of /STATS report"},
+	{RPL_STATSDEBUG, ":{0}"},
+	{RPL_NOTOPIC, "{0} :No topic is set"},
+	{RPL_TOPIC, "{0} :{1}"},
+	{RPL_TOPICWHOTIME, "{0} {1} {2}"},
+	{RPL_INVITING, "{0} {1}"},
+	{RPL_NAMREPLY, "= {0} :{1}"},
+	{RPL_ENDOFNAMES, "{0} :End of /NAMES list"},
+	{ERR_UNKNOWNERROR, "{0} :{1}"},
+	{ERR_NOSUCHNICK, "{0} :No such nick/channel"},
+	{ERR_NOSUCHCHANNEL, "{0} :No such channel"},
+	{ERR_NOORIGIN, ":No origin specified"},
+	{ERR_NOTEXTTOSEND, ":No text to send"},
+	{ERR_INPUTTOOLONG, ":Input line was too long"},
+	{ERR_UNKNOWNCOMMAND, "{0} :Unknown command"},
+	{ERR_ERRONEUSNICKNAME, "{0} :Erroneous nickname"},
+	{ERR_NICKNAMEINUSE, "{0} :Nickname is already in use"},
+	{ERR_USERNOTINCHANNEL, "{0} {1} :They aren't on that channel"},
+	{ERR_NOTONCHANNEL, "{0} :You're not on that channel"},
+	{ERR_USERONCHANNEL, "{0} {1} :is already on channel"},
+	{ERR_NOTREGISTERED, ":You have not registered"},
+	{ERR_NEEDMOREPARAMS, "{0} :Not enough parameters"},
+	{ERR_PASSWDMISMATCH, ":Password incorrect"},
+	{ERR_CHANNELISFULL, "{0} :Cannot join channel (+l)"},
+	{ERR_UNKNOWNMODE, "{0} :is unknown mode char to me"},
+	{ERR_INVITEONLYCHAN, "{0} :Cannot join channel (+i)"},
+	{ERR_BADCHANNELKEY, "{0} :Cannot join channel (+k)"},
+	{ERR_NOPRIVILEGES, ":Permission Denied- You're not an IRC operator"},
+	{ERR_CHANOPRIVSNEEDED, "{0} :You're not channel operator"},
+};
+
+/* --------------------------------------------------------------------------------- */
+/* Constructors & Destructors                                                        */
+/* --------------------------------------------------------------------------------- */
+Replies::Replies(const std::string &serverName) : _serverName(serverName) {
+	for (size_t i = 0; i < sizeof(replyFormats) / sizeof(replyFormats[0]); ++i) {
+		_compile(replyFormats[i].numeric, replyFormats[i].format);
+	}
+}
+
+Replies::~Replies() {}
+
+/* --------------------------------------------------------------------------------- */
+/* Templates                                                                         */
+/* --------------------------------------------------------------------------------- */
+// parses a format into the segments of ":<server> <code> <target> <format>\r\n"
+void Replies::_compile(Numeric numeric, const char *format) {
+	std::vector<Segment> &segments = _templates[numeric];
+	char code[4] = {static_cast<char>('0' + numeric / 100), static_cast<char>('0' + numeric / 10 % 10),
+		static_cast<char>('0' + numeric % 10), '\0'};
+	_addLiteral(segments, ":");
+	_addLiteral(segments, _serverName);
+	_addLiteral(segments, " ");
+	_addLiteral(segments, code);
+	_addLiteral(segments, " ");
+	segments.push_back(Segment{0, 0, 0});
+	_addLiteral(segments, " ");
+	std::string_view rest(format);
+	while (!rest.empty()) {
+		if (rest.size() >= 3 && rest[0] == '{' && rest[1] >= '0' && rest[1] <= '9' && rest[2] == '}') {
+			segments.push_back(Segment{0, 0, rest[1] - '0' + 1});
+			rest.remove_prefix(3);
+			continue;
+		}
+		size_t end = rest.find('{', 1);
+		if (end == std::string_view::npos) {
+			end = rest.size();
+		}
+		_addLiteral(segments, rest.substr(0, end));
+		rest.remove_prefix(end);
+	}
+	_addLiteral(segments, "\r\n");
+}
+
+// appends a literal run, merged into the previous one when that ends where this one starts
+void Replies::_addLiteral(std::vector<Segment> &segments, std::string_view text) {
+	uint32_t offset = static_cast<uint32_t>(_literals.size());
+	_literals.append(text.data(), text.size());
+	if (!segments.empty() && segments.back().slot == -1 && segments.back().offset + segments.back().size == offset) {
+		segments.back().size += static_cast<uint32_t>(text.size());
+		return;
+	}
+	segments.push_back(Segment{offset, static_cast<uint32_t>(text.size()), -1});
+}
+
+// returns the value of a slot, a parameter the caller did not pass is empty
+std::string_view Replies::_slot(int slot, std::string_view target, std::initializer_list<std::string_view> params) {
+	if (slot == 0) {
+		return target;
+	}
+	size_t index = static_cast<size_t>(slot - 1);
+	return index < params.size() ? params.begin()[index] : std::string_view();
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Rendering                                                                         */
+/* --------------------------------------------------------------------------------- */
+// returns the size of the line including its CRLF, 0 for a numeric without template
+size_t Replies::Measure(Numeric numeric, std::string_view target,
+	std::initializer_list<std::string_view> params) const {
+	size_t size = 0;
+	for (const Segment &segment : _templates[numeric]) {
+		size += segment.slot == -1 ? segment.size : _slot(segment.slot, target, params).size();
+	}
+	return size;
+}
+
+// writes the line into out, which has room for Measure bytes
+void Replies::Render(Numeric numeric, std::string_view target, std::initializer_list<std::string_view> params,
+	char *out) const {
+	for (const Segment &segment : _templates[numeric]) {
+		if (segment.slot == -1) {
+			std::memcpy(out, _literals.data() + segment.offset, segment.size);
+			out += segment.size;
+		} else {
+			std::string_view value = _slot(segment.slot, target, params);
+			if (!value.empty()) {
+				std::memcpy(out, value.data(), value.size());
+				out += value.size();
+			}
+		}
+	}
+}
+
+// returns the name the server puts in front of its replies
+const std::string& Replies::GetServerName() const {
+	return _serverName;
+}
@@ -8,8 +8,7 @@
 // authenticates a client if the password is correct
 void Server::Authenticate(int clientSocket, const std::vector<std::string>& tokens) {
 	if (tokens.size() != 1 || tokens[0] != GetPassword()) {
-		std::string err = "464 " + _clients[clientSocket].GetNickName() + " PASS :Password incorrect\r\n";
-		send(clientSocket, err.c_str(), err.size(), 0);
+		_reply(clientSocket, ERR_PASSWDMISMATCH);
 		// PREVIOUS APPROACH: HandleDisconnection(clientSocket); // Disconnect the client on failed authentication
 //		RemoveClient(clientSocket); // forcibly disconnect
 	} else {
@@ -23,7 +22,7 @@ void Server::Authenticate(int clientSocket, const std::vector<std::string>& toke
 void Server::RegisterClientIfReady(int clientSocket) {
 	Client &c = _clients[clientSocket];
 	if (c.GetAuthenticated() && !c.GetNickName().empty() && !c.GetUserName().empty()) {
-		std::string welcome = "001 " + c.GetNickName() + " :Welcome to the IRC Server\r\n";
-		send(clientSocket, welcome.c_str(), welcome.size(), 0);
+		c.SetRegistered(true);
+		_reply(clientSocket, RPL_WELCOME, {c.GetPrefix()});
 	}
 }
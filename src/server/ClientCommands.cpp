@@ -13,8 +13,7 @@
 void Server::Nick(int clientSocket, const std::vector<std::string>& tokens) {
 	// 1) Expect exactly one parameter for /nick
 	if (tokens.size() != 1) {
-		std::string err = ":" + _clients[clientSocket].GetNickName() + " 461 NICK :Not enough parameters\r\n";
-		send(clientSocket, err.c_str(), err.size(), 0);
+		_reply(clientSocket, ERR_NEEDMOREPARAMS, {"NICK"});
 		return;
 	}
 
@@ -23,8 +22,7 @@ void Server::Nick(int clientSocket, const std::vector<std::string>& tokens) {
 	// 2) Check first character: letter, '_' or '-', not a digit
 	char firstChar = validatedNick[0];
 	if (!std::isalpha(static_cast<unsigned char>(firstChar)) && firstChar != '_' && firstChar != '-') {
-		std::string err = ":" + validatedNick + " 432 " + validatedNick + " :Invalid first character in nickname\r\n";
-		send(clientSocket, err.c_str(), err.size(), 0);
+		_reply(clientSocket, ERR_ERRONEUSNICKNAME, {validatedNick});
 		return;
 	}
 
@@ -32,21 +30,18 @@ void Server::Nick(int clientSocket, const std::vector<std::string>& tokens) {
 	for (char c : validatedNick) {
 		unsigned char uc = static_cast<unsigned char>(c);
 		if (!std::isalnum(uc) && c != '_' && c != '-') {
-			std::string err = ":" + validatedNick + " 432 " + validatedNick + " :Invalid character in nickname\r\n";
-			send(clientSocket, err.c_str(), err.size(), 0);
+			_reply(clientSocket, ERR_ERRONEUSNICKNAME, {validatedNick});
 			return;
 		}
 		if (uc < 32 || c == ' ' || c == ',') {
-			std::string err = ":" + validatedNick + " 432 " + validatedNick + " :Forbidden character in nickname\r\n";
-			send(clientSocket, err.c_str(), err.size(), 0);
+			_reply(clientSocket, ERR_ERRONEUSNICKNAME, {validatedNick});
 			return;
 		}
 	}
 
 	// 4) Optional: enforce an upper length limit (example: 30)
 	if (validatedNick.size() > 30) {
-		std::string err = ":" + validatedNick + " 432 " + validatedNick + " :Nickname too long\r\n";
-		send(clientSocket, err.c_str(), err.size(), 0);
+		_reply(clientSocket, ERR_ERRONEUSNICKNAME, {validatedNick});
 		return;
 	}
 
@@ -54,31 +49,48 @@ void Server::Nick(int clientSocket, const std::vector<std::string>& tokens) {
 	std::string oldNick = _clients[clientSocket].GetNickName();
 	std::string newNick = tokens[0];
 
-	// Check for nickname conflicts
-	for (std::map<int, Client>::iterator it = _clients.begin(); it != _clients.end(); ++it) {
-		if (it->first != clientSocket && it->second.GetNickName() == newNick) {
-			std::string err = ":" + oldNick + " 433 " + newNick + " :Nickname is already in use\r\n";
-			send(clientSocket, err.c_str(), err.size(), 0);
-			return;
-		}
+	// Check for nickname conflicts, nicknames differing only in case are the same
+	int holder = _findClientFromNickname(newNick);
+	if (holder != -1 && holder != clientSocket) {
+		_reply(clientSocket, ERR_NICKNAMEINUSE, {newNick});
+		return;
 	}
 
 	// If the user tries to set the same nickname, optionally reject it
 	if (newNick == oldNick) {
-		std::string err = ":" + oldNick + " 433 " + newNick + " :Nickname is old Nickname\r\n";
-		send(clientSocket, err.c_str(), err.size(), 0);
+		_reply(clientSocket, ERR_NICKNAMEINUSE, {newNick});
 		return;
 	}
 
+	// Clients of other shards may hold the nickname as well, a change of case keeps the claim
+	if (_bus && holder != clientSocket) {
+		if (!_bus->ClaimNick(newNick, _shardId)) {
+			_reply(clientSocket, ERR_NICKNAMEINUSE, {newNick});
+			return;
+		}
+		if (!oldNick.empty()) {
+			_bus->ReleaseNick(oldNick, _shardId);
+		}
+	}
+
 	// Assign the new nickname
+	if (!oldNick.empty()) {
+		_nicknames.erase(oldNick);
+	}
+	_nicknames[newNick] = clientSocket;
+	// the line carries the old prefix, build it before the nick changes
+	std::string_view nickMsg = oldNick.empty() ? std::string_view() : _userMessage(clientSocket, {"NICK :", newNick});
 	_clients[clientSocket].SetNickName(newNick);
+	// the channel directory lists the members by nick
+	if (_bus && !oldNick.empty()) {
+		for (const std::string &channelName : _clients[clientSocket].GetChannels()) {
+			_bus->RenameMember(channelName, oldNick, newNick);
+		}
+	}
 
-	// Broadcast the nick change to the channels
-	std::string nickMsg = ":" + oldNick + " NICK :" + newNick + "\r\n";
-	for (std::map<std::string, Channel>::iterator it = _channels.begin(); it != _channels.end(); ++it) {
-		Channel &channel = it->second;
-		// Only inform channels the client is already in
-		_BroadcastToChannel(channel.GetName(), nickMsg);
+	// Tell the client & everyone sharing a channel with it about the nick change
+	if (!oldNick.empty()) {
+		_broadcastToPeers(clientSocket, nickMsg, -1);
 	}
 
 	// Attempt to register if PASS, NICK, and USER are set
@@ -88,9 +100,7 @@ void Server::Nick(int clientSocket, const std::vector<std::string>& tokens) {
 // sets the username of a client
 void Server::User(int clientSocket, const std::vector<std::string>& tokens) {
 	if (tokens.size() < 4) {
-		std::string err = ":" + _clients[clientSocket].GetNickName() +
-						" 461 USER :Not enough parameters\r\n";
-		send(clientSocket, err.c_str(), err.size(), 0);
+		_reply(clientSocket, ERR_NEEDMOREPARAMS, {"USER"});
 		return;
 	}
 
@@ -122,46 +132,41 @@ void Server::User(int clientSocket, const std::vector<std::string>& tokens) {
 }
 
 void Server::Join(int clientSocket, const std::vector<std::string>& tokens) {
-	std::string serverName = "127.0.0.1:6667"; // or your real server hostname/IP
-
-	if (!_clients[clientSocket].GetAuthenticated()) {
-		std::string err = ":" + _clients[clientSocket].GetNickName() + " 464 JOIN :You're not authenticated\r\n";
-		send(clientSocket, err.c_str(), err.size(), 0);
-		return;
-	}
-	if (_clients[clientSocket].GetNickName().empty() || _clients[clientSocket].GetUserName().empty()) {
-		std::string err = ":" + _clients[clientSocket].GetNickName() + " 451 JOIN :You have not registered\r\n";
-		send(clientSocket, err.c_str(), err.size(), 0);
+	if (!_clients[clientSocket].GetRegistered()) {
+		_reply(clientSocket, ERR_NOTREGISTERED);
 		return;
 	}
 	if (tokens.size() < 1 || tokens.size() > 2) {
-		std::string err = ":" + _clients[clientSocket].GetNickName() + " 461 JOIN :Incorrect amount for parameters\r\n";
-		send(clientSocket, err.c_str(), err.size(), 0);
+		_reply(clientSocket, ERR_NEEDMOREPARAMS, {"JOIN"});
 		return;
 	}
 
-	// Utility lambda to split string by a delimiter.
-	auto splitString = [](const std::string &s, char delimiter) -> std::vector<std::string> {
-		std::vector<std::string> parts;
-		std::istringstream iss(s);
-		std::string token;
-		while (std::getline(iss, token, delimiter)) {
-			parts.push_back(token);
+	// Utility lambda to split string by a delimiter, the parts are views into s.
+	auto splitString = [this](const std::string &s, char delimiter) -> ArenaVector<std::string_view> {
+		ArenaVector<std::string_view> parts(_arena);
+		size_t start = 0;
+		while (start < s.size()) {
+			size_t end = s.find(delimiter, start);
+			if (end == std::string::npos) {
+				end = s.size();
+			}
+			parts.push_back(std::string_view(s).substr(start, end - start));
+			start = end + 1;
 		}
 		return parts;
 	};
 
 	// Split the channels (and keys, if provided) by comma.
-	std::vector<std::string> channelNames = splitString(tokens[0], ',');
-	std::vector<std::string> keys;
+	ArenaVector<std::string_view> channelNames = splitString(tokens[0], ',');
+	ArenaVector<std::string_view> keys(_arena);
 	if (tokens.size() > 1) {
 		keys = splitString(tokens[1], ',');
 	}
 
 	// Process each channel join request.
 	for (size_t i = 0; i < channelNames.size(); i++) {
-		std::string channelName = channelNames[i];
-		std::string providedKey = (i < keys.size()) ? keys[i] : "";
+		std::string channelName(channelNames[i]);
+		std::string_view providedKey = (i < keys.size()) ? keys[i] : std::string_view();
 
 		// If channel name doesn't start with '#', treat as private message channel.
 		if (!channelName.empty() && !channelPrefixCheck(channelName)) {
@@ -170,94 +175,91 @@ void Server::Join(int clientSocket, const std::vector<std::string>& tokens) {
 			std::vector<std::string> nicks = {senderNick, targetNick};
 			std::sort(nicks.begin(), nicks.end());
 			std::string pmChannel = "#pm-" + nicks[0] + "-" + nicks[1];
-			if (_channels.find(pmChannel) == _channels.end()) {
-				std::string err = ":" + senderNick + " 404 " + targetNick + " :No private message channel with that user\r\n";
-				send(clientSocket, err.c_str(), err.size(), 0);
+			if (!_findChannel(pmChannel)) {
+				_reply(clientSocket, ERR_NOSUCHCHANNEL, {targetNick});
 				continue;
 			}
 			channelName = pmChannel; // update to the PM channel name
 		}
 
 		if (channelNameCheck(channelName)) {
-			std::string err = ":" + _clients[clientSocket].GetNickName() + " 403 " + channelName + " :No such channel\r\n";
-			send(clientSocket, err.c_str(), err.size(), 0);
+			_reply(clientSocket, ERR_NOSUCHCHANNEL, {channelName});
 			continue;
 		}
 
-		// If channel doesn't exist, create it, set operator, etc.
-		if (_channels.find(channelName) == _channels.end()) {
-			_channels[channelName] = Channel();
-			_channels[channelName].SetName(channelName);
-			if (!providedKey.empty()) {
-				_channels[channelName].SetPassword(providedKey);
-			}
-			_changeOperatorPrivileges(channelName, _clients[clientSocket].GetNickName(), true);
-		}
-
-		Channel& channel = _channels[channelName];
-
-		// Check if user is already on that channel
-		if (std::find(channel.GetUsers().begin(), channel.GetUsers().end(), clientSocket) != channel.GetUsers().end()) {
-			std::string err = ":" + _clients[clientSocket].GetNickName() + " 443 " + channelName + " :You are already on that channel\r\n";
-			send(clientSocket, err.c_str(), err.size(), 0);
+		// Check if user is already on that channel, names differing only in case are the same channel
+		if (_clients[clientSocket].IsInChannel(channelName)) {
+			const Channel *joined = _findChannel(channelName);
+			_reply(clientSocket, ERR_USERONCHANNEL, {_clients[clientSocket].GetNickName(),
+				joined ? joined->GetName() : channelName});
 			continue;
 		}
 
-		// Check +l (user limit)
-		if (channel.GetUserLimit() > NO_USER_LIMIT && channel.GetUsers().size() >= channel.GetUserLimit()) {
-			std::string err = ":" + _clients[clientSocket].GetNickName() + " 471 " + channelName
-				+ " :Cannot join channel, user limit exceeded (+l)\r\n";
-			send(clientSocket, err.c_str(), err.size(), 0);
+		// Check +l, +i & +k, if channel doesn't exist, create it with the user as operator
+		Channel *admitted = _admitJoin(clientSocket, channelName, providedKey);
+		if (!admitted) {
 			continue;
 		}
+		Channel &channel = *admitted;
+		// Replies & the join line carry the name the channel was created with
+		const std::string &name = channel.GetName();
 
-		// Check +i (invite-only)
-		if (channel.GetInviteOnly()) {
-			const std::vector<int>& invitedList = channel.GetInvited();
-			if (std::find(invitedList.begin(), invitedList.end(), clientSocket) == invitedList.end()) {
-				std::string err = ":" + _clients[clientSocket].GetNickName() + " 473 " + channelName
-					+ " :Cannot join channel, invite is required (+i)\r\n";
-				send(clientSocket, err.c_str(), err.size(), 0);
-				continue;
-			}
-		}
+		// Add user to channel, this uses up the invite
+		_addChannelMember(channel, clientSocket);
 
-		// Check +k (channel password)
-		if (!channel.GetPassword().empty() && providedKey != channel.GetPassword()) {
-			std::string err = _errMsg(_clients[clientSocket].GetNickName(), "475", channelName, "Cannot join channel (+k)");
-			send(clientSocket, err.c_str(), err.size(), 0);
-			continue;
-		}
+		// Broadcast join
+		std::string_view joinMsg = _userMessage(clientSocket, {"JOIN :", name});
+		_BroadcastToChannel(channel, joinMsg);
+
+		// Send the topic & the member list after the join (WeeChat & most IRC clients expect this).
+		_replyTopic(clientSocket, channel);
+		_replyNames(clientSocket, channel);
+	}
+}
 
-		// Add user to channel and remove them from Invited list
-		channel.AddUser(clientSocket);
-		std::vector<int>& invited = channel.GetInvited();
-		invited.erase(std::remove(invited.begin(), invited.end(), clientSocket), invited.end());
+// sends the topic of a channel with who set it & when, or that there is none
+void Server::_replyTopic(int clientSocket, const Channel &channel) {
+	if (channel.GetTopic().empty()) {
+		_reply(clientSocket, RPL_NOTOPIC, {channel.GetName()});
+		return;
+	}
+	_reply(clientSocket, RPL_TOPIC, {channel.GetName(), channel.GetTopic()});
+	_reply(clientSocket, RPL_TOPICWHOTIME, {channel.GetName(), channel.GetTopicSetBy(),
+		std::to_string(channel.GetTopicSetTime())});
+}
 
-		// Broadcast join
-		std::string joinMsg = ":" + _clients[clientSocket].GetNickName() + " JOIN :" + channelName + "\r\n";
-		_BroadcastToChannel(channelName, joinMsg);
-
-		// NEW: Send RPL_TOPIC info after user joins (WeeChat & most IRC clients expect this).
-		if (channel.GetTopic().empty()) {
-			// 331: RPL_NOTOPIC
-			std::string rplNoTopic = ":" + serverName + " 331 " +
-				_clients[clientSocket].GetNickName() + " " + channelName + " :No topic is set\r\n";
-			send(clientSocket, rplNoTopic.c_str(), rplNoTopic.size(), 0);
-		} else {
-			// 332: RPL_TOPIC
-			std::string rplTopic = ":" + serverName + " 332 " +
-				_clients[clientSocket].GetNickName() + " " + channelName + " :" + channel.GetTopic() + "\r\n";
-			send(clientSocket, rplTopic.c_str(), rplTopic.size(), 0);
-
-			// 333: RPL_TOPICWHOTIME (optional but expected by many IRC clients)
-			// Format: 333 <nick> <channel> <whoSetTopic> <when>
-			std::string rplTopicWhoTime = ":" + serverName + " 333 " +
-				_clients[clientSocket].GetNickName() + " " + channelName + " " +
-				channel.GetTopicSetBy() + " " + std::to_string(channel.GetTopicSetTime()) + "\r\n";
-			send(clientSocket, rplTopicWhoTime.c_str(), rplTopicWhoTime.size(), 0);
+// lists the members of a channel, operators marked with '@', over as many lines as needed
+void Server::_replyNames(int clientSocket, const Channel &channel) {
+	ArenaString names(_arena);
+	// appends a member, sending the line first if the name does not fit
+	auto addName = [&](std::string_view nick, bool isOperator) {
+		if (!names.empty() && names.size() + nick.size() + 2 > NAMES_LINE_SIZE) {
+			_reply(clientSocket, RPL_NAMREPLY, {channel.GetName(), names});
+			names.clear();
+		}
+		if (!names.empty()) {
+			names += ' ';
+		}
+		if (isOperator) {
+			names += '@';
 		}
+		names.append(nick.data(), nick.size());
+	};
+	// with shards the channel directory holds the members of every shard
+	if (_bus) {
+		_bus->ForEachMember(channel.GetName(), addName);
+	} else {
+		for (const ChannelMember &member : channel.GetMembers()) {
+			const Client *client = _clients.Find(member.fd);
+			if (client) {
+				addName(client->GetNickName(), member.flags & MEMBER_OPERATOR);
+			}
+		}
+	}
+	if (!names.empty()) {
+		_reply(clientSocket, RPL_NAMREPLY, {channel.GetName(), names});
 	}
+	_reply(clientSocket, RPL_ENDOFNAMES, {channel.GetName()});
 }
 
 
@@ -265,143 +267,176 @@ void Server::Join(int clientSocket, const std::vector<std::string>& tokens) {
 void Server::PrivMsg(int clientSocket, const std::vector<std::string>& tokens) {
 	// 1) Ensure user is authenticated.
 	if (!_clients[clientSocket].GetAuthenticated()) {
-		std::string err = ":" + _clients[clientSocket].GetNickName() + " 464 PRIVMSG :You are not authenticated\r\n";
-		send(clientSocket, err.c_str(), err.size(), 0);
+		_reply(clientSocket, ERR_NOTREGISTERED);
 		return;
 	}
 
 	// 2) Check for correct parameter count.
 	if (tokens.size() < 2) {
-		std::string err = ":" + _clients[clientSocket].GetNickName() + " 461 PRIVMSG :Not enough parameters\r\n";
-		send(clientSocket, err.c_str(), err.size(), 0);
+		_reply(clientSocket, ERR_NEEDMOREPARAMS, {"PRIVMSG"});
 		return;
 	}
 
 	// 3) Parse target and message.
 	std::string target = tokens[0];
-	std::string message;
+	ArenaString message(_arena);
 	for (size_t i = 1; i < tokens.size(); ++i) {
 		if (!message.empty())
 			message += " ";
 		message += tokens[i];
 	}
 
-	// Lambda to trim whitespace from both ends.
-	auto trim = [](const std::string& str) -> std::string {
+	// Lambda to trim whitespace from both ends, returns a view into str.
+	auto trim = [](std::string_view str) -> std::string_view {
 		size_t first = str.find_first_not_of(" \t\r\n");
-		if (first == std::string::npos)
-			return "";
+		if (first == std::string_view::npos)
+			return std::string_view();
 		size_t last = str.find_last_not_of(" \t\r\n");
 		return str.substr(first, last - first + 1);
 	};
 
 	// Trim the message and check if it's empty or only whitespace.
-	std::string trimmedMessage = trim(message);
+	std::string_view trimmedMessage = trim(message);
 	if (trimmedMessage.empty()) {
-		std::string err = ":" + _clients[clientSocket].GetNickName() +
-						  " 412 PRIVMSG :No text to send\r\n";
-		send(clientSocket, err.c_str(), err.size(), 0);
+		_reply(clientSocket, ERR_NOTEXTTOSEND);
 		return;
 	}
 
 	// Check for forbidden characters (newline, carriage return, or non-whitespace control chars)
 	for (char c : message) {
 		if (c == '\n' || c == '\r' || (std::iscntrl(static_cast<unsigned char>(c)) && !std::isspace(static_cast<unsigned char>(c)))) {
-			std::string err = ":" + _clients[clientSocket].GetNickName() +
-							  " 412 PRIVMSG :Invalid characters in message\r\n";
-			send(clientSocket, err.c_str(), err.size(), 0);
+			_reply(clientSocket, ERR_UNKNOWNERROR, {"PRIVMSG", "Invalid characters in message"});
 			return;
 		}
 	}
 
-	// If the user typed a channel name without '#', add '#' if that channel exists
-	if (!target.empty() && target[0] != '#') {
-		std::string candidate = "#" + target;
-		if (_channels.find(target) != _channels.end()) {
-			target = candidate;
-		}
-	}
-
-	// Build a more standard prefix like: nick!user@host
-	std::string prefix = _clients[clientSocket].GetNickName() + "!" +
-						 _clients[clientSocket].GetUserName() +
-						 "@127.0.0.1"; // or your actual IP/host
-
 	// 4) Full message to relay: ":<nick!user@host> PRIVMSG <target> :<message>"
-	std::string fullMsg = ":" + prefix + " PRIVMSG " + target + " :" + message + "\r\n";
+	std::string_view fullMsg = _userMessage(clientSocket, {"PRIVMSG ", target, " :", message});
 
 	// 5) If target is a channel, ensure it exists and user is in it, then broadcast.
-	if (!target.empty() && target[0] == '#') {
-		if (_channels.find(target) == _channels.end()) {
-			std::string err = ":" + _clients[clientSocket].GetNickName() + " 403 " + target + " :No such channel\r\n";
-			send(clientSocket, err.c_str(), err.size(), 0);
+	if (channelPrefixCheck(target)) {
+		Channel *channel = _findChannel(target);
+		if (!channel) {
+			_reply(clientSocket, ERR_NOSUCHCHANNEL, {target});
 			return;
 		}
-		Channel &channel = _channels[target];
-		if (std::find(channel.GetUsers().begin(), channel.GetUsers().end(), clientSocket) == channel.GetUsers().end()) {
-			std::string err = ":" + _clients[clientSocket].GetNickName() + " 442 " + target + " :You're not on that channel\r\n";
-			send(clientSocket, err.c_str(), err.size(), 0);
+		if (!_clients[clientSocket].IsInChannel(target)) {
+			_reply(clientSocket, ERR_NOTONCHANNEL, {target});
 			return;
 		}
-		// Broadcast to all members in the channel (including sender).
-		for (int userFd : channel.GetUsers()) {
-			if (userFd == clientSocket)
-				continue; // Skip sending to sender to avoid duplicate display.
-			if (send(userFd, fullMsg.c_str(), fullMsg.size(), 0) == -1) {
-				perror("Error sending PRIVMSG to channel user");
-				// Remove user from channel and log
-				std::cout << "Removing user " << userFd << " from channel " << channel.GetName()
-						  << " due to send failure" << std::endl;
-				channel.RemoveUser(userFd);
-				// Consider also removing from other channels and closing connection
-				HandleDisconnection(userFd);
-			}
+		// Store it for CHATHISTORY, with shards in the one history all of them share
+		uint64_t msgid = _newMsgid();
+		if (_bus) {
+			_bus->AppendHistory(channel->GetName(), msgid, _wallMs, fullMsg);
+		} else {
+			channel->GetHistory().Append(msgid, _wallMs, fullMsg);
 		}
+		// Broadcast to all members in the channel, skip the sender to avoid duplicate display.
+		_deliverToChannel(*channel, fullMsg, clientSocket, SEND_LOW);
+		_relayChannelLine(channel->GetName(), fullMsg, SEND_LOW);
 	} else {
-		// 6) Otherwise, treat as direct message to a nick.
+		// 6) Otherwise, treat as direct message to a nick, possibly connected to another shard.
 		int targetFd = _findClientFromNickname(target);
-		if (targetFd == -1) {
-			std::string err = ":" + _clients[clientSocket].GetNickName() + " 401 " + target + " :No such nick\r\n";
-			send(clientSocket, err.c_str(), err.size(), 0);
+		if (targetFd == -1 && _relayUserLine(target, fullMsg)) {
 			return;
 		}
-		if (send(targetFd, fullMsg.c_str(), fullMsg.size(), 0) == -1) {
-			perror("Error sending PRIVMSG to user");
-			// Remove user and close connection
-			// std::cout << "Removing user " << targetFd << " due to send failure" << std::endl;
-			HandleDisconnection(targetFd);
+		if (targetFd == -1) {
+			_reply(clientSocket, ERR_NOSUCHNICK, {target});
+			return;
 		}
+		_sendToClient(targetFd, fullMsg);
 	}
 }
 
-void Server::_BroadcastToChannel(const std::string &channelName, const std::string &msg) {
-	if (_channels.find(channelName) != _channels.end()) {
-		Channel &channel = _channels[channelName];
-		for (int userFd : channel.GetUsers()) {
-			send(userFd, msg.c_str(), msg.size(), 0);
-			// std::cout << "Broadcasting to " << userFd << ": " << msg;
-		}
-	}
+void Server::_BroadcastToChannel(const Channel &channel, std::string_view msg) {
+	_deliverToChannel(channel, msg, -1);
+	_relayChannelLine(channel.GetName(), msg);
 }
 
 
 void Server::Quit(int clientSocket, const std::vector<std::string>& /*tokens*/) {
 	std::string quitMessage = "Client Quit";
-	std::string broadcastMsg = ":" + _clients[clientSocket].GetNickName() +
-							   " QUIT :" + quitMessage + "\r\n";
-
-	for (auto &it : _channels) {
-		Channel &channel = it.second;
-		// Check if user is in the channel
-		if (std::find(channel.GetUsers().begin(), channel.GetUsers().end(), clientSocket) != channel.GetUsers().end()) {
-			// Broadcast the QUIT message to everyone in that channel
-			_BroadcastToChannel(channel.GetName(), broadcastMsg);
-			// Remove the user from the channel
-			channel.RemoveUser(clientSocket);
-		}
-	}
+	std::string_view broadcastMsg = _userMessage(clientSocket, {"QUIT :", quitMessage});
+
+	// Broadcast the QUIT message once to everyone in the user's channels, then leave them
+	_broadcastToPeers(clientSocket, broadcastMsg, -1);
+	_leaveAllChannels(clientSocket);
 
 	// Log and disconnect the client
 	// std::cout << "Client " << _clients[clientSocket].GetNickName() << " (" << clientSocket << ") quitting: " << quitMessage << std::endl;
 	HandleDisconnection(clientSocket);
 }
+
+// reports the counters of this shard, STATS l [nick] sums up the lagging clients or shows the link info of the caller
+void Server::Stats(int clientSocket, const std::vector<std::string>& tokens) {
+	if (!_clients[clientSocket].GetRegistered()) {
+		_reply(clientSocket, ERR_NOTREGISTERED);
+		return;
+	}
+
+	std::string_view query = tokens.empty() ? std::string_view("*") : std::string_view(tokens[0]);
+	if (query == "l" || query == "L") {
+		// there are no server operators, so nobody sees the link info of another client
+		if (tokens.size() > 1) {
+			if (_findClientFromNickname(tokens[1]) != clientSocket) {
+				_reply(clientSocket, ERR_NOPRIVILEGES);
+				return;
+			}
+			const Client &client = _clients[clientSocket];
+			_reply(clientSocket, RPL_STATSLINKINFO, {client.GetNickName(), std::to_string(client.GetPendingSize()),
+				std::to_string(client.GetDroppedMessages()), std::to_string(client.GetRtt()),
+				std::to_string((_nowMs - client.GetLastActivity()) / 1000)});
+		} else {
+			// clients above the sendq high-water mark, only as totals
+			size_t lagging = 0;
+			size_t queued = 0;
+			size_t dropped = 0;
+			for (int fd : _clients.GetFds()) {
+				const Client &client = _clients[fd];
+				if (client.GetPendingSize() >= _config.sendqHighWater || client.GetSendqExceeded()) {
+					++lagging;
+					queued += client.GetPendingSize();
+					dropped += client.GetDroppedMessages();
+				}
+			}
+			_reply(clientSocket, RPL_STATSDEBUG, {_arena.Concat({"lagging ", std::to_string(lagging), " clients, ",
+				std::to_string(queued), " bytes queued, ", std::to_string(dropped), " dropped"})});
+		}
+		_reply(clientSocket, RPL_ENDOFSTATS, {query});
+		return;
+	}
+
+	const AdmissionStats &stats = _admission.GetStats();
+	auto replyDebug = [&](std::initializer_list<std::string_view> parts) {
+		_reply(clientSocket, RPL_STATSDEBUG, {_arena.Concat(parts)});
+	};
+	replyDebug({"clients ", std::to_string(_clients.size()), " max ", std::to_string(_maxClients)});
+	replyDebug({"accepted ", std::to_string(stats.accepted)});
+	replyDebug({"rejected-max-clients ", std::to_string(stats.rejectedMaxClients)});
+	replyDebug({"rejected-per-ip ", std::to_string(stats.rejectedPerIp)});
+	replyDebug({"rejected-rate ", std::to_string(stats.rejectedRate)});
+	replyDebug({"accept-errors ", std::to_string(stats.acceptErrors)});
+	replyDebug({"tracked-addresses ", std::to_string(_admission.GetTrackedAddresses())});
+	const BufferPoolStats &pool = _recvPool.GetStats();
+	replyDebug({"recv-slabs ", std::to_string(pool.slabsInUse), "/", std::to_string(pool.slabs), " in use, ",
+		std::to_string(pool.slabs * RECV_SLAB_SIZE), " bytes"});
+	replyDebug({"recv-oversized ", std::to_string(pool.oversizedInUse), " in use, ",
+		std::to_string(pool.oversizedBytes), " bytes"});
+	replyDebug({"line-scanner ", LineScanner::GetVariant()});
+	const ArenaStats &arena = _arena.GetStats();
+	replyDebug({"arena ", std::to_string(arena.blocks), " blocks, ", std::to_string(arena.peakBytes), " peak bytes, ",
+		std::to_string(arena.oversized), " oversized"});
+	size_t historyBytes = 0;
+	size_t historyChannels = _channels.size();
+	if (_bus) {
+		_bus->GetHistoryUsage(historyBytes, historyChannels);
+	} else {
+		for (ChannelMap::const_iterator it = _channels.begin(); it != _channels.end(); ++it) {
+			historyBytes += it->second.GetHistory().GetUsedBytes();
+		}
+	}
+	replyDebug({"history ", std::to_string(historyBytes), " bytes in ", std::to_string(historyChannels), " channels"});
+	replyDebug({"sendq-evicted ", std::to_string(_sendqStats.evicted)});
+	replyDebug({"sendq-dropped ", std::to_string(_sendqStats.droppedMessages)});
+	_reply(clientSocket, RPL_ENDOFSTATS, {query});
+}
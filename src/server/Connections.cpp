@@ -8,91 +8,273 @@
 /* --------------------------------------------------------------------------------- */
 /* Connection Handling                                                               */
 /* --------------------------------------------------------------------------------- */
-// handles a new connection
+// accepts every pending connection, up to MAX_ACCEPTS_PER_WAKEUP per call
 void Server::HandleNewConnection() {
+	for (int accepted = 0; accepted < MAX_ACCEPTS_PER_WAKEUP; ++accepted) {
+		sockaddr_in clientAddr;
+		socklen_t addrSize = sizeof(clientAddr);
+#ifdef __linux__
+		int clientFd = accept4(_listeningFd, reinterpret_cast<sockaddr*>(&clientAddr), &addrSize,
+			SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+		int clientFd = accept(_listeningFd, reinterpret_cast<sockaddr*>(&clientAddr), &addrSize);
+		if (clientFd >= 0) {
+			fcntl(clientFd, F_SETFL, O_NONBLOCK);
+		}
+#endif
+		if (clientFd >= 0) {
+			_admitClient(clientFd, clientAddr);
+			continue;
+		}
+		if (errno == EINTR || errno == ECONNABORTED) {
+			continue;
+		}
+		if (errno == EAGAIN || errno == EWOULDBLOCK) {
+			return;
+		}
+		_admission.CountAcceptError();
+		if (errno == EMFILE || errno == ENFILE) {
+			_refuseWithSpareFd();
+		}
+		return;
+	}
+}
+
+// frees the spare fd to take one connection off the backlog & refuse it, false if none could be taken off
+bool Server::_refuseWithSpareFd() {
+	if (_spareFd == -1) {
+		// lost to an earlier shortage, try to get it back for the next one
+		_spareFd = open("/dev/null", O_RDONLY);
+		return false;
+	}
+	close(_spareFd);
 	sockaddr_in clientAddr;
 	socklen_t addrSize = sizeof(clientAddr);
 	int clientFd = accept(_listeningFd, reinterpret_cast<sockaddr*>(&clientAddr), &addrSize);
 	if (clientFd >= 0) {
-		fcntl(clientFd, F_SETFL, O_NONBLOCK);
-		// Register new client in poll
-		struct pollfd pfd;
-		pfd.fd = clientFd;
-		pfd.events = POLLIN;
-		_pollFds.push_back(pfd);
+		_rejectClient(clientFd, clientAddr, ADMISSION_MAX_CLIENTS);
+	}
+	_spareFd = open("/dev/null", O_RDONLY);
+	return clientFd >= 0;
+}
 
-		_clients[clientFd] = Client(clientFd);
+// checks the connection limits, refuses the connection or creates its client
+void Server::_admitClient(int clientFd, const sockaddr_in &clientAddr) {
+	uint32_t address = clientAddr.sin_addr.s_addr;
+	AdmissionResult result = _admission.Admit(address, _clients.size(), _maxClients, std::time(nullptr));
+	if (result != ADMISSION_OK) {
+		_rejectClient(clientFd, clientAddr, result);
+		return;
 	}
+	_acceptClient(clientFd, address);
 }
 
-// handles a connection
+// sends a single ERROR line without allocating a client & closes the connection
+void Server::_rejectClient(int clientFd, const sockaddr_in &clientAddr, AdmissionResult reason) {
+	const char *why = "Too many connections";
+	if (reason == ADMISSION_PER_IP_LIMIT) {
+		why = "Too many connections from your host";
+	} else if (reason == ADMISSION_RATE_LIMIT) {
+		why = "Connecting too fast, throttled";
+	}
+	char host[INET_ADDRSTRLEN] = "unknown";
+	inet_ntop(AF_INET, &clientAddr.sin_addr, host, sizeof(host));
+	std::string err = std::string("ERROR :Closing Link: ") + host + " (" + why + ")\r\n";
+	ssize_t ret = send(clientFd, err.c_str(), err.size(), MSG_DONTWAIT);
+	(void)ret; // best effort, the connection is closed either way
+	close(clientFd);
+}
+
+// registers an accepted socket with the I/O backend & creates its client
+void Server::_acceptClient(int clientFd, uint32_t address) {
+	if (_uring) {
+		// Multishot recv keeps delivering data until the client is released
+		if (static_cast<size_t>(clientFd) >= _uringSlots.size()) {
+			_uringSlots.resize(clientFd + 1, UringSlot());
+		}
+		_uringSlots[clientFd].sendsInFlight = 0;
+		_uring->PrepareMultishotRecv(clientFd, _uringUserData(URING_OP_RECV, clientFd));
+	} else if (!_poller->Add(clientFd, POLLER_READ, true)) {
+		// Register new client with the poller, edge triggered so reads must drain the socket
+		_admission.Release(address, std::time(nullptr));
+		close(clientFd);
+		return;
+	}
+
+	Client &client = _clients.Insert(clientFd, Client(clientFd, &_recvPool));
+	client.SetAddress(address);
+	client.SetLastActivity(_nowMs);
+	_startClientTimer(clientFd);
+}
+
+// handles a connection, reads straight into the client's receive buffer until the socket is drained
 void Server::HandleConnection(int clientSocket) {
-	char buffer[MAX_BUFFER_SIZE + 1];
-	std::memset(buffer, 0, sizeof(buffer));
-	ssize_t bytesRead = recv(clientSocket, buffer, MAX_BUFFER_SIZE, 0);
-	if (bytesRead > 0) {
-		// Check if the client is still in the map
-		if (_clients.find(clientSocket) == _clients.end()) {
+	while (true) {
+		Client *client = _clients.Find(clientSocket);
+		if (!client) {
 			return; // Client has been removed, exit the function
 		}
+		RecvBuffer &buffer = client->GetRecvBuffer();
+		char *dst = buffer.Reserve(MAX_BUFFER_SIZE);
+		ssize_t bytesRead = recv(clientSocket, dst, buffer.GetWritableSize(), 0);
+		if (bytesRead == 0) {
+			HandleDisconnection(clientSocket);
+			return;
+		}
+		if (bytesRead < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			if (errno == EAGAIN || errno == EWOULDBLOCK) {
+				// idle until the next read, keep a slab only for a partial line
+				buffer.ReleaseIfEmpty();
+				return;
+			}
+			throw std::runtime_error("Failed to receive message");
+		}
+		buffer.Commit(static_cast<size_t>(bytesRead));
+		if (!_drainLines(clientSocket)) {
+			return;
+		}
+	}
+}
 
-		std::string msg(buffer, bytesRead);
-
-		std::string clientBuffer = _clients[clientSocket].GetMsgBuffer();
-		clientBuffer.append(msg);
-		_clients[clientSocket].SetMsgBuffer(clientBuffer);
+// runs complete lines of received bytes, only a trailing partial line is copied to the client
+void Server::_handleInput(int clientSocket, const char *data, size_t size) {
+	Client *client = _clients.Find(clientSocket);
+	if (!client) {
+		return; // Client has been removed, exit the function
+	}
+	if (!client->GetRecvBuffer().Empty() || client->GetRecvBuffer().IsDiscarding()) {
+		// a partial line is pending, the new bytes have to be joined with it or dropped
+		client->GetRecvBuffer().Append(data, size);
+		if (_drainLines(clientSocket)) {
+			_clients[clientSocket].GetRecvBuffer().ReleaseIfEmpty();
+		}
+		return;
+	}
 
-//		for real irc client, check for \r\n instead!
-		if (clientBuffer.empty()) {
+	size_t pos;
+	while ((pos = LineScanner::FindLineFeed(data, size)) != std::string_view::npos) {
+		if (!_handleLine(clientSocket, std::string_view(data, LineScanner::GetLineLength(data, pos)))) {
 			return;
 		}
-		size_t pos;
-		while ((pos = clientBuffer.find("\r\n")) != std::string::npos) {
-			std::string commandLine = clientBuffer.substr(0, pos);
-			clientBuffer.erase(0, pos + 2); // Remove processed command
-			_clients[clientSocket].SetMsgBuffer(clientBuffer);
-
-			// Parse commandLine into tokens
-			std::tuple<Method, std::vector<std::string>> vals = _parser.parse(commandLine);
-
-			// Handle message
-			if (std::get<0>(vals) == INVALID) {
-				std::string commandName = (!std::get<1>(vals).empty()) ? std::get<1>(vals).front() : "";
-				std::string err = "421 " + _clients[clientSocket].GetNickName() + " " + commandName + " :Unknown command\r\n";
-				send(clientSocket, err.c_str(), err.size(), 0);
-				continue; // Continue processing other commands
-			}
+		data += pos + 1;
+		size -= pos + 1;
+	}
+	if (size > 0) {
+		_clients[clientSocket].GetRecvBuffer().Append(data, size);
+		if (size >= MAX_LINE_SIZE) {
+			// the fragment can never become a valid line, let the buffer reject it now
+			_drainLines(clientSocket);
+		}
+	}
+}
 
-			// Execute the corresponding command handler
-			(this->*_methods[std::get<0>(vals)])(clientSocket, std::get<1>(vals));
+// runs every complete line in the client's receive buffer, returns false if the client is gone
+bool Server::_drainLines(int clientSocket) {
+	std::string_view line;
+	while (true) {
+		Client *client = _clients.Find(clientSocket);
+		if (!client) {
+			return false;
 		}
-	} else if (bytesRead == 0) {
-		HandleDisconnection(clientSocket);
-	} else {
-		throw std::runtime_error("Failed to receive message");
+		LineStatus status = client->GetRecvBuffer().NextLine(line);
+		if (status == LINE_NONE) {
+			return true;
+		}
+		if (status == LINE_TOO_LONG) {
+			_replyLineTooLong(clientSocket);
+			continue;
+		}
+		if (!_handleLine(clientSocket, line)) {
+			return false;
+		}
+	}
+}
+
+// tells a client its line was longer than MAX_LINE_LENGTH
+void Server::_replyLineTooLong(int clientSocket) {
+	_reply(clientSocket, ERR_INPUTTOOLONG);
+}
+
+// parses & runs one command line, returns false if the client is gone afterwards
+bool Server::_handleLine(int clientSocket, std::string_view line) {
+	_clients[clientSocket].SetLastActivity(_nowMs);
+
+	// Parse the line, the views point into the receive buffer
+	MessageView msg;
+	ParseResult result = _parser.Parse(line, msg);
+	if (result == PARSE_EMPTY) {
+		return true;
+	}
+	if (result == PARSE_TOO_LONG) {
+		_replyLineTooLong(clientSocket);
+		return true;
+	}
+
+	// Handle message
+	if (_methods[msg.method] == nullptr) {
+		_reply(clientSocket, ERR_UNKNOWNCOMMAND, {msg.command});
+		return true; // Continue processing other commands
+	}
+
+	// Handlers take owned strings, the vector keeps its capacity between lines
+	_params.resize(msg.paramCount);
+	for (size_t i = 0; i < msg.paramCount; ++i) {
+		_params[i].assign(msg.params[i].data(), msg.params[i].size());
 	}
+
+	// Execute the corresponding command handler
+	(this->*_methods[msg.method])(clientSocket, _params);
+
+	// QUIT (or a failed send) may have disconnected the client
+	return _clients.Contains(clientSocket);
 }
 
 // handles a disconnection
 void Server::HandleDisconnection(int clientSocket) {
-	_clients.erase(clientSocket);
+	// the fd may be reused by accept before the end of this iteration
+	_pendingDisconnects.erase(std::remove(_pendingDisconnects.begin(), _pendingDisconnects.end(), clientSocket),
+		_pendingDisconnects.end());
+	if (_uring) {
+		_releaseUringClient(clientSocket);
+	} else {
+		_poller->Remove(clientSocket);
+	}
+	Client *client = _clients.Find(clientSocket);
+	if (client) {
+		_admission.Release(client->GetAddress(), std::time(nullptr));
+		// a client that vanished without QUIT still leaves its channels
+		if (!client->GetChannels().empty()) {
+			_broadcastToPeers(clientSocket, _userMessage(clientSocket, {"QUIT :Connection closed"}), clientSocket);
+			_leaveAllChannels(clientSocket);
+		}
+	}
+	_timers.Cancel(clientSocket);
+	if (client && !client->GetNickName().empty()) {
+		_nicknames.erase(client->GetNickName());
+		if (_bus) {
+			_bus->ReleaseNick(client->GetNickName(), _shardId);
+		}
+	}
+	_clients.Erase(clientSocket);
 	close(clientSocket);
-	_pollFds.erase(std::remove_if(_pollFds.begin(), _pollFds.end(), [clientSocket](const pollfd &fd) {
-		return fd.fd == clientSocket;
-	}), _pollFds.end());
+}
+
+// closes every client scheduled for disconnection, including those scheduled while closing others
+void Server::_removePendingClients() {
+	while (!_pendingDisconnects.empty()) {
+		int clientFd = _pendingDisconnects.back();
+		_pendingDisconnects.pop_back();
+		RemoveClient(clientFd);
+	}
 }
 
 // removes a client from the server
 void Server::RemoveClient(int clientFd) {
-	if (_clients.find(clientFd) != _clients.end())
-		close(clientFd);
-		_clients.erase(clientFd);
-
-	for (std::vector<struct pollfd>::iterator it = _pollFds.begin(); it != _pollFds.end(); ++it) {
-		if (it->fd == clientFd) {
-			_pollFds.erase(it);
-			break;
-		}
+	if (_clients.Contains(clientFd)) {
+		HandleDisconnection(clientFd);
 	}
 }
 
@@ -108,16 +290,158 @@ bool Server::HandleClient(int clientFd) {
 	return true;
 }
 
+// writes as much of a client's outbound queue as the socket accepts, false on a fatal error
+bool Server::FlushClient(int clientFd) {
+	Client *found = _clients.Find(clientFd);
+	if (!found) {
+		return true;
+	}
+	Client &client = *found;
+	if (_uring) {
+		_submitUringSends(clientFd);
+		return true;
+	}
+	struct iovec iov[MAX_FLUSH_IOV];
+	while (client.HasPendingOutput()) {
+		int iovCount = client.GetPendingIovecs(iov, MAX_FLUSH_IOV);
+		ssize_t bytesSent = writev(clientFd, iov, iovCount);
+		if (bytesSent < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			if (errno == EAGAIN || errno == EWOULDBLOCK) {
+				break;
+			}
+			return false;
+		}
+		client.ConsumePending(static_cast<size_t>(bytesSent));
+	}
+
+	// only wait for writability while there is something left to send
+	bool wantsWrite = client.HasPendingOutput();
+	if (wantsWrite != client.GetWriteArmed()) {
+		_poller->Modify(clientFd, wantsWrite ? POLLER_READ | POLLER_WRITE : POLLER_READ);
+		client.SetWriteArmed(wantsWrite);
+	}
+	return true;
+}
+
+// queues a message for a client, the actual write happens once at the end of the loop iteration
+void Server::_sendToClient(int clientFd, std::string_view msg, SendPriority priority) {
+	Client *client = _admitOutput(clientFd, msg.size(), priority);
+	if (client) {
+		client->QueueMessage(msg);
+		_scheduleFlush(clientFd, *client);
+	}
+}
+
+// queues a reference to an encoded line for a client, used by fan-out so the line is not copied per recipient
+void Server::_sendToClient(int clientFd, const SendBuffer &buffer, SendPriority priority) {
+	Client *client = _admitOutput(clientFd, buffer.GetSize(), priority);
+	if (client) {
+		client->QueueBuffer(buffer);
+		_scheduleFlush(clientFd, *client);
+	}
+}
+
+// applies the sendq limits to size more bytes, returns the client if they may be queued
+Client* Server::_admitOutput(int clientFd, size_t size, SendPriority priority) {
+	Client *found = _clients.Find(clientFd);
+	if (!found || found->GetSendqExceeded()) {
+		return nullptr;
+	}
+	Client &client = *found;
+	size_t pending = client.GetPendingSize();
+	if (pending + size > _config.sendqHighWater && !client.GetWriteArmed()) {
+		// a big burst within one iteration is not lagging yet, hand it to the socket before judging
+		if (!FlushClient(clientFd)) {
+			_scheduleDisconnect(clientFd);
+		}
+		pending = client.GetPendingSize();
+	}
+	if (priority == SEND_LOW && pending >= _config.sendqHighWater) {
+		// the client is lagging, chatter is dropped before it counts against the hard limit
+		client.CountDroppedMessage();
+		++_sendqStats.droppedMessages;
+		return nullptr;
+	}
+	if (pending + size > _config.sendqLimit) {
+		_evictSlowConsumer(clientFd, client);
+		return nullptr;
+	}
+	return found;
+}
+
+// puts a client with fresh output on the end of iteration flush list
+void Server::_scheduleFlush(int clientFd, Client &client) {
+	// a client waiting for writability is flushed by its write event instead
+	if (!client.GetFlushScheduled() && !client.GetWriteArmed()) {
+		client.SetFlushScheduled(true);
+		_pendingFlushes.push_back(clientFd);
+	}
+}
+
+// queues a last ERROR line for a client over its sendq limit & closes it at the end of the iteration
+void Server::_evictSlowConsumer(int clientFd, Client &client) {
+	client.SetSendqExceeded(true);
+	client.QueueMessage("ERROR :SendQ exceeded\r\n");
+	// one last write attempt before the close, even if the client already waits for writability
+	if (!client.GetFlushScheduled()) {
+		client.SetFlushScheduled(true);
+		_pendingFlushes.push_back(clientFd);
+	}
+	++_sendqStats.evicted;
+	_scheduleDisconnect(clientFd);
+}
+
+// flushes every client that got output queued during this loop iteration
+void Server::_flushPendingOutput() {
+	for (size_t i = 0; i < _pendingFlushes.size(); ++i) {
+		int clientFd = _pendingFlushes[i];
+		Client *client = _clients.Find(clientFd);
+		if (!client || !client->GetFlushScheduled()) {
+			continue;
+		}
+		client->SetFlushScheduled(false);
+		if (!FlushClient(clientFd)) {
+			_scheduleDisconnect(clientFd);
+		}
+	}
+	_pendingFlushes.clear();
+}
+
+// flushes the pending output & removes the pending clients until neither is left,
+// the QUIT lines of a removed client go out in the same iteration
+void Server::_settlePending() {
+	while (!_pendingFlushes.empty() || !_pendingDisconnects.empty()) {
+		_flushPendingOutput();
+		_removePendingClients();
+	}
+}
+
+// disconnects a client at the end of the current loop iteration
+void Server::_scheduleDisconnect(int clientFd) {
+	_pendingDisconnects.push_back(clientFd);
+}
+
 // handle PING
 void Server::Ping(int clientFd, const std::vector<std::string>& tokens) {
 	// If no parameter was sent, ignore or send an error.
 	if (tokens.size() < 1) {
-		std::string err("409 :No origin specified\r\n");
-		send(clientFd, err.c_str(), err.size(), 0);
+		_reply(clientFd, ERR_NOORIGIN);
 		return;
 	}
 	// typical format: PING <server-name>
 	// respond with PONG <server-name>
 	std::string response = "PONG " + tokens[0] + "\r\n";
-	send(clientFd, response.c_str(), response.size(), 0);
+	_sendToClient(clientFd, response);
+}
+
+// answers a keepalive PING, the time since it was sent is the client's round trip time
+void Server::Pong(int clientFd, const std::vector<std::string>& /*tokens*/) {
+	Client &client = _clients[clientFd];
+	if (client.GetPingSentAt() != 0) {
+		client.SetRtt(static_cast<int64_t>(_nowMs - client.GetPingSentAt()));
+		client.SetPingSentAt(0);
+	}
 }
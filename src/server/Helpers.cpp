@@ -31,21 +31,46 @@ Mode _strToModeEnum(std::string str) {
 	}
 }
 
-// finds a user from a nickname
-int Server::_findClientFromNickname(std::string nickname) {
-	for (auto it = _clients.begin(); it != _clients.end(); ++it) {
-		if (it->second.GetNickName() == nickname) {
-			return it->first;
-		}
+// finds a local user from a nickname in any case, -1 if nobody uses it
+int Server::_findClientFromNickname(const std::string &nickname) const {
+	std::unordered_map<std::string, int, CaseFoldHash, CaseFoldEqual>::const_iterator it = _nicknames.find(nickname);
+	return it == _nicknames.end() ? -1 : it->second;
+}
+
+// returns ":<nick!user@host> <parts...>\r\n" for a line sent on behalf of a client, valid until the end of the iteration
+std::string_view Server::_userMessage(int clientFd, std::initializer_list<std::string_view> parts) {
+	const std::string &prefix = _clients[clientFd].GetPrefix();
+	size_t size = prefix.size() + 4;
+	for (std::string_view part : parts) {
+		size += part.size();
 	}
-	return -1;
+	char *data = static_cast<char *>(_arena.Allocate(size, 1));
+	char *out = data;
+	*out++ = ':';
+	out = std::copy(prefix.begin(), prefix.end(), out);
+	*out++ = ' ';
+	for (std::string_view part : parts) {
+		out = std::copy(part.begin(), part.end(), out);
+	}
+	*out++ = '\r';
+	*out++ = '\n';
+	return std::string_view(data, size);
 }
 
-std::string _errMsg(const std::string& nick, const std::string& code, const std::string& msg, const std::string&
-reason) {
-	std::ostringstream err;
-	err << ":" << nick << " " << code << " " << msg << " :" << reason << "\r\n";
-	return err.str();
+// queues a numeric reply to a client, rendered straight into its send queue
+void Server::_reply(int clientFd, Numeric numeric, std::initializer_list<std::string_view> params) {
+	Client *client = _clients.Find(clientFd);
+	if (!client) {
+		return;
+	}
+	// a client without a nickname yet is addressed as "*"
+	std::string_view target = client->GetNickName().empty() ? std::string_view("*") : client->GetNickName();
+	size_t size = _replies.Measure(numeric, target, params);
+	client = _admitOutput(clientFd, size, SEND_NORMAL);
+	if (client) {
+		_replies.Render(numeric, target, params, client->ReserveMessage(size));
+		_scheduleFlush(clientFd, *client);
+	}
 }
 
 bool Server::channelPrefixCheck(const std::string& channelName) {
@@ -74,4 +99,135 @@ bool Server::channelNameCheck(const std::string& channelName) {
 		return true;
 	}
 	return false;
-}
\ No newline at end of file
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Channel Membership                                                                */
+/* --------------------------------------------------------------------------------- */
+// returns the channel of a name in any case, nullptr if there is none
+Channel* Server::_findChannel(const std::string &channelName) {
+	ChannelMap::iterator it = _channels.find(channelName);
+	return it == _channels.end() ? nullptr : &it->second;
+}
+
+// adds a client to the members of a channel & the channel to the client's joined set
+void Server::_addChannelMember(Channel &channel, int clientFd) {
+	channel.AddUser(_clients.GetHandle(clientFd));
+	_clients[clientFd].AddChannel(channel.GetName());
+}
+
+// removes a client & its channel status from a channel & the channel from the client's joined set
+void Server::_removeChannelMember(Channel &channel, int clientFd) {
+	// frees its seat in the server wide member count & list
+	if (_bus && _clients[clientFd].IsInChannel(channel.GetName())) {
+		_bus->LeaveChannel(channel.GetName(), _clients[clientFd].GetNickName(), _shardId);
+	}
+	channel.RemoveUser(clientFd);
+	_clients[clientFd].RemoveChannel(channel.GetName());
+}
+
+// removes a client from a channel given by name, which may not exist on this shard
+void Server::_removeChannelMember(const std::string &channelName, int clientFd) {
+	Channel *channel = _findChannel(channelName);
+	if (channel) {
+		_removeChannelMember(*channel, clientFd);
+		return;
+	}
+	_clients[clientFd].RemoveChannel(channelName);
+}
+
+// checks +l, +i & +k of a channel, with shards against its server wide state, & creates it if it does not exist
+// returns the local channel the client may join, nullptr after replying why it may not
+Channel* Server::_admitJoin(int clientFd, const std::string &channelName, std::string_view key) {
+	Channel *channel = _findChannel(channelName);
+	bool invited = channel && channel->IsInvited(_clients.GetHandle(clientFd));
+	ChannelState state;
+	JoinResult result = JOIN_OK;
+	if (_bus) {
+		// another shard may have created the channel & set its modes, only the directory knows
+		result = _bus->JoinChannel(channelName, key, invited, _clients[clientFd].GetNickName(), _shardId, state);
+	} else if (!channel) {
+		state.name = channelName;
+		state.key.assign(key.data(), key.size());
+		result = JOIN_CREATED;
+	} else if (channel->GetUserLimit() > NO_USER_LIMIT && channel->GetUserCount() >= channel->GetUserLimit()) {
+		result = JOIN_FULL;
+	} else if (channel->GetInviteOnly() && !invited) {
+		result = JOIN_INVITE_ONLY;
+	} else if (!channel->GetPassword().empty() && key != channel->GetPassword()) {
+		result = JOIN_BAD_KEY;
+	}
+
+	const std::string &name = channel ? channel->GetName() : state.name;
+	switch (result) {
+		case JOIN_FULL:
+			_reply(clientFd, ERR_CHANNELISFULL, {name});
+			return nullptr;
+		case JOIN_INVITE_ONLY:
+			_reply(clientFd, ERR_INVITEONLYCHAN, {name});
+			return nullptr;
+		case JOIN_BAD_KEY:
+			_reply(clientFd, ERR_BADCHANNELKEY, {name});
+			return nullptr;
+		case JOIN_CREATED:
+		case JOIN_OK:
+			break;
+	}
+	// the local copy of a shard without members misses topic changes, every join brings it up to date
+	if (_bus || !channel) {
+		channel = &_localChannel(state);
+	}
+	// only the client creating the channel server wide becomes its operator
+	if (result == JOIN_CREATED) {
+		channel->MakeOperator(_clients.GetHandle(clientFd));
+	}
+	return channel;
+}
+
+// returns the local copy of a channel, created on first use & set to its server wide state
+Channel& Server::_localChannel(const ChannelState &state) {
+	std::pair<ChannelMap::iterator, bool> inserted = _channels.try_emplace(state.name);
+	Channel &channel = inserted.first->second;
+	if (inserted.second) {
+		channel.SetName(state.name);
+		// with shards the history is kept in the channel directory
+		if (!_bus) {
+			channel.GetHistory().SetBudget(_config.historyBytes);
+		}
+	}
+	channel.SetPassword(state.key);
+	channel.SetInviteOnly(state.inviteOnly);
+	channel.SetTopicOnlySettableByOperator(state.topicRestricted);
+	channel.SetUserLimit(state.userLimit);
+	channel.SetTopic(state.topic);
+	channel.SetTopicSetBy(state.topicSetBy);
+	channel.SetTopicSetTime(state.topicSetTime);
+	return channel;
+}
+
+// returns if only operators may set the topic, with shards the server wide state holds the mode
+bool Server::_isTopicRestricted(const Channel &channel) const {
+	ChannelState state;
+	if (_bus && _bus->FindChannel(channel.GetName(), state)) {
+		return state.topicRestricted;
+	}
+	return channel.GetTopicOnlySettableByOperator();
+}
+
+// removes a client from every channel it joined
+void Server::_leaveAllChannels(int clientFd) {
+	const JoinedChannels &channels = _clients[clientFd].GetChannels();
+	while (!channels.empty()) {
+		// the set entry is erased on the way, keep the name alive
+		std::string channelName = *channels.begin();
+		_removeChannelMember(channelName, clientFd);
+	}
+}
+
+// sends a line once to the client & everyone sharing a channel with it, on this & the other shards
+void Server::_broadcastToPeers(int clientFd, std::string_view msg, int exceptFd) {
+	const JoinedChannels &joined = _clients[clientFd].GetChannels();
+	std::vector<std::string> channels(joined.begin(), joined.end());
+	_deliverToChannels(channels, msg, exceptFd, clientFd);
+	_relayChannelsLine(channels, msg);
+}
@@ -0,0 +1,157 @@
+//
+// Created on 10/18/26.
+//
+
+#include "Server.hpp"
+#include <charconv>
+
+// most messages a single CHATHISTORY request returns
+#define CHATHISTORY_MAX_LIMIT 100
+
+// a message reference of a CHATHISTORY request, resolved to positions in the history
+struct HistoryReference {
+//	index of the first entry at or after the reference & of the first one after it
+	size_t at;
+	size_t after;
+};
+
+// parses a decimal number into value, false on anything else
+static bool parseNumber(std::string_view text, uint64_t &value) {
+	const char *end = text.data() + text.size();
+	std::from_chars_result result = std::from_chars(text.data(), end, value);
+	return !text.empty() && result.ec == std::errc() && result.ptr == end;
+}
+
+// resolves msgid=<id> or timestamp=<time>, false if the reference is malformed
+// a msgid that is no longer stored resolves to an empty range
+static bool resolveReference(const ChannelHistory &history, std::string_view text, HistoryReference &ref) {
+	if (text.compare(0, 6, "msgid=") == 0) {
+		uint64_t msgid;
+		if (!parseNumber(text.substr(6), msgid)) {
+			return false;
+		}
+		size_t index = history.Find(msgid);
+		if (index == ChannelHistory::npos) {
+			ref.at = 0;
+			ref.after = history.size();
+		} else {
+			ref.at = index;
+			ref.after = index + 1;
+		}
+		return true;
+	}
+	if (text.compare(0, 10, "timestamp=") == 0) {
+		int64_t timeMs;
+		if (!ChannelHistory::ParseTime(text.substr(10), timeMs)) {
+			return false;
+		}
+		ref.at = history.FindTime(timeMs);
+		ref.after = history.FindTime(timeMs + 1);
+		return true;
+	}
+	return false;
+}
+
+// replays the history of a channel, CHATHISTORY LATEST|BEFORE|AFTER <channel> <*|msgid=id|timestamp=time> <limit>
+void Server::ChatHistory(int clientSocket, const std::vector<std::string>& tokens) {
+	if (!_clients[clientSocket].GetRegistered()) {
+		_reply(clientSocket, ERR_NOTREGISTERED);
+		return;
+	}
+	if (tokens.size() < 4) {
+		_reply(clientSocket, ERR_NEEDMOREPARAMS, {"CHATHISTORY"});
+		return;
+	}
+
+	std::string subcommand = tokens[0];
+	std::transform(subcommand.begin(), subcommand.end(), subcommand.begin(), ::toupper);
+	if (subcommand != "LATEST" && subcommand != "BEFORE" && subcommand != "AFTER") {
+		_failHistory(clientSocket, "INVALID_PARAMS", subcommand, "Unknown subcommand");
+		return;
+	}
+
+	const std::string &target = tokens[1];
+	const Channel *channel = _findChannel(target);
+	if (!channel || !_clients[clientSocket].IsInChannel(target)) {
+		_failHistory(clientSocket, "INVALID_TARGET", _arena.Concat({subcommand, " ", target}),
+			"Messages could not be retrieved");
+		return;
+	}
+
+	uint64_t limit;
+	if (!parseNumber(tokens[3], limit) || limit == 0) {
+		_failHistory(clientSocket, "INVALID_PARAMS", subcommand, "Invalid limit");
+		return;
+	}
+	limit = std::min(limit, static_cast<uint64_t>(CHATHISTORY_MAX_LIMIT));
+
+	// with shards the history is shared in the channel directory, it stays locked while the batch is built
+	if (_bus) {
+		_bus->ReadHistory(channel->GetName(), [&](const ChannelHistory &history) {
+			_replayHistory(clientSocket, subcommand, *channel, history, tokens[2], limit);
+		});
+	} else {
+		_replayHistory(clientSocket, subcommand, *channel, channel->GetHistory(), tokens[2], limit);
+	}
+}
+
+// sends at most limit lines of a history around a reference in one chathistory batch
+void Server::_replayHistory(int clientSocket, const std::string &subcommand, const Channel &channel,
+	const ChannelHistory &history, std::string_view reference, uint64_t limit) {
+	// select the range [begin, end) of the history, at most limit entries
+	size_t begin;
+	size_t end;
+	HistoryReference ref;
+	if (subcommand == "LATEST" && reference == "*") {
+		ref.at = 0;
+		ref.after = 0;
+	} else if (!resolveReference(history, reference, ref)) {
+		_failHistory(clientSocket, "INVALID_PARAMS", subcommand, "Invalid message reference");
+		return;
+	}
+	if (subcommand == "BEFORE") {
+		end = ref.at;
+		begin = end - std::min<size_t>(end, limit);
+	} else if (subcommand == "AFTER") {
+		begin = ref.after;
+		end = begin + std::min<size_t>(history.size() - begin, limit);
+	} else {
+		end = history.size();
+		begin = std::max<size_t>(ref.after, end - std::min<size_t>(end, limit));
+	}
+
+	// the whole batch is one send, every line carries its original time & msgid as tags
+	std::string batch = std::to_string(++_historyBatches);
+	ArenaString out(_arena);
+	out.reserve((end - begin) * (MAX_LINE_SIZE + 64) + 128);
+	out.append(_arena.Concat({":", _replies.GetServerName(), " BATCH +", batch, " chathistory ",
+		channel.GetName(), "\r\n"}));
+	char time[HISTORY_TIME_SIZE];
+	for (size_t i = begin; i < end; ++i) {
+		const HistoryEntry &entry = history.At(i);
+		ChannelHistory::FormatTime(entry.timeMs, time);
+		out.append("@batch=");
+		out.append(batch);
+		out.append(";time=");
+		out.append(time, HISTORY_TIME_SIZE);
+		out.append(";msgid=");
+		out.append(std::to_string(entry.msgid));
+		out.append(" ");
+		out.append(history.GetLine(entry));
+	}
+	out.append(_arena.Concat({":", _replies.GetServerName(), " BATCH -", batch, "\r\n"}));
+	_sendToClient(clientSocket, out);
+}
+
+// sends an IRCv3 standard reply, :<server> FAIL CHATHISTORY <code> <context> :<description>
+void Server::_failHistory(int clientFd, std::string_view code, std::string_view context,
+	std::string_view description) {
+	_sendToClient(clientFd, _arena.Concat({":", _replies.GetServerName(), " FAIL CHATHISTORY ", code, " ", context,
+		" :", description, "\r\n"}));
+}
+
+// returns a msgid that is unique across the shards & restarts of the server
+uint64_t Server::_newMsgid() {
+	size_t shards = _bus ? _bus->GetShardCount() : 1;
+	return _msgidCounter++ * shards + _shardId;
+}
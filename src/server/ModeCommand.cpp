@@ -8,8 +8,7 @@
 void Server::Mode(int clientSocket, const std::vector<std::string>& tokens) {
 	// Expected command format: MODE <channel> <mode> [parameters...]
 	if (tokens.size() < 2) {
-		std::string err = "IRC 461 MODE :Not enough parameters\r\n";
-		send(clientSocket, err.c_str(), err.size(), 0);
+		_reply(clientSocket, ERR_NEEDMOREPARAMS, {"MODE"});
 		return;
 	}
 
@@ -17,128 +16,157 @@ void Server::Mode(int clientSocket, const std::vector<std::string>& tokens) {
 	std::string modeStr = tokens[1];
 
 	// Check whether channel exists.
-	if (_channels.find(channelName) == _channels.end()) {
-		std::string err = "IRC 403 " + channelName + " :No such channel\r\n";
-		send(clientSocket, err.c_str(), err.size(), 0);
+	Channel *found = _findChannel(channelName);
+	if (!found) {
+		_reply(clientSocket, ERR_NOSUCHCHANNEL, {channelName});
 		return;
 	}
 
-	Channel &channel = _channels[channelName];
+	Channel &channel = *found;
 	// Check whether client is a channel operator.
-	if (std::find(channel.GetOperators().begin(), channel.GetOperators().end(), clientSocket) == channel.GetOperators().end()) {
-		std::string err = "IRC 482 " + channelName + " :You're not channel operator\r\n";
-		send(clientSocket, err.c_str(), err.size(), 0);
+	if (!channel.IsUserOperator(_clients.GetHandle(clientSocket))) {
+		_reply(clientSocket, ERR_CHANOPRIVSNEEDED, {channelName});
 		return;
 	}
 
 	// Use the enum from the global namespace to avoid name conflict with the member function.
 	::Mode mode = _strToModeEnum(modeStr);
+	// +o, -o, +l & +k without their argument
+	if ((mode == GIVE_OPERATOR_PRIVILEGES || mode == TAKE_OPERATOR_PRIVILEGES || mode == SET_USER_LIMIT
+		|| mode == SET_PASSWORD) && tokens.size() < 3) {
+		_reply(clientSocket, ERR_NEEDMOREPARAMS, {"MODE"});
+		return;
+	}
 
 	try {
 		switch (mode) {
 			case MAKE_INVITE_ONLY:
 				if (tokens.size() != 2)
 					throw std::runtime_error("Usage: MODE <channel> +i");
-				_changeInviteOnlyRestriction(channelName, true);
+				_changeInviteOnlyRestriction(channel, true);
 				break;
 			case UNMAKE_INVITE_ONLY:
 				if (tokens.size() != 2)
 					throw std::runtime_error("Usage: MODE <channel> -i");
-				_changeInviteOnlyRestriction(channelName, false);
+				_changeInviteOnlyRestriction(channel, false);
 				break;
 			case MAKE_TOPIC_ONLY_SETTABLE_BY_OPERATOR:
 				if (tokens.size() != 2)
 					throw std::runtime_error("Usage: MODE <channel> +t");
-				_changeTopicRestriction(channelName, true);
+				_changeTopicRestriction(channel, true);
 				break;
 			case UNMAKE_TOPIC_ONLY_SETTABLE_BY_OPERATOR:
 				if (tokens.size() != 2)
 					throw std::runtime_error("Usage: MODE <channel> -t");
-				_changeTopicRestriction(channelName, false);
+				_changeTopicRestriction(channel, false);
 				break;
 			case GIVE_OPERATOR_PRIVILEGES:
 				if (tokens.size() != 3)
 					throw std::runtime_error("Usage: MODE <channel> +o <nick>");
-				_changeOperatorPrivileges(channelName, tokens[2], true);
+				if (!_changeOperatorPrivileges(channel, tokens[2], true)) {
+					_reply(clientSocket, ERR_NOSUCHNICK, {tokens[2]});
+					return;
+				}
 				break;
 			case TAKE_OPERATOR_PRIVILEGES:
 				if (tokens.size() != 3)
 					throw std::runtime_error("Usage: MODE <channel> -o <nick>");
-				_changeOperatorPrivileges(channelName, tokens[2], false);
+				if (!_changeOperatorPrivileges(channel, tokens[2], false)) {
+					_reply(clientSocket, ERR_NOSUCHNICK, {tokens[2]});
+					return;
+				}
 				break;
 			case SET_USER_LIMIT:
 				if (tokens.size() != 3)
 					throw std::runtime_error("Usage: MODE <channel> +l <limit>");
-				_changeUserLimitRestriction(channelName, std::stoul(tokens[2]));
+				_changeUserLimitRestriction(channel, std::stoul(tokens[2]));
 				break;
 			case UNSET_USER_LIMIT:
 				if (tokens.size() != 2)
 					throw std::runtime_error("Usage: MODE <channel> -l");
-				_changeUserLimitRestriction(channelName, NO_USER_LIMIT);
+				_changeUserLimitRestriction(channel, NO_USER_LIMIT);
 				break;
 			case SET_PASSWORD:
 				if (tokens.size() != 3)
 					throw std::runtime_error("Usage: MODE <channel> +k <password>");
-				_changePasswordRestriction(channelName, tokens[2]);
+				_changePasswordRestriction(channel, tokens[2]);
 				break;
 			case UNSET_PASSWORD:
 				if (tokens.size() != 2)
 					throw std::runtime_error("Usage: MODE <channel> -k");
-				_changePasswordRestriction(channelName, "");
+				_changePasswordRestriction(channel, "");
 				break;
 			default:
-			{
-				std::string err = "IRC 421 MODE " + modeStr + " :Unknown MODE command\r\n";
-				send(clientSocket, err.c_str(), err.size(), 0);
+				_reply(clientSocket, ERR_UNKNOWNMODE, {modeStr});
 				return;
-			}
 		}
 
 		// After a successful mode change, inform all users in the channel.
-		std::string response = ":" + _clients[clientSocket].GetNickName() + " MODE " + channelName + " " + modeStr;
-		if (tokens.size() > 2) {
-			for (size_t i = 2; i < tokens.size(); i++) {
-				response += " " + tokens[i];
-			}
-		}
-		response += "\r\n";
-		_BroadcastToChannel(channelName, response);
+		std::string_view response = _userMessage(clientSocket, {"MODE ", channelName, " ", modeStr,
+			tokens.size() > 2 ? " " : "", tokens.size() > 2 ? tokens[2] : ""});
+		_BroadcastToChannel(channel, response);
 
 	} catch (std::exception &e) {
-		std::string err = "IRC 461 MODE " + channelName + " :" + e.what() + "\r\n";
-		send(clientSocket, err.c_str(), err.size(), 0);
+		_reply(clientSocket, ERR_UNKNOWNERROR, {"MODE", e.what()});
 	}
 }
 
 // changes the topic restriction of a channel
-void Server::_changeTopicRestriction(std::string channel, bool isTopicOnlySettableByOperator) {
-	_channels[channel].SetTopicOnlySettableByOperator(isTopicOnlySettableByOperator);
+void Server::_changeTopicRestriction(Channel &channel, bool isTopicOnlySettableByOperator) {
+	channel.SetTopicOnlySettableByOperator(isTopicOnlySettableByOperator);
+	if (_bus) {
+		_bus->ChangeChannel(channel.GetName(), [&](ChannelState &state) {
+			state.topicRestricted = isTopicOnlySettableByOperator;
+		});
+	}
 }
 
 // changes the password restriction of a channel
-void Server::_changePasswordRestriction(std::string channel, std::string password) {
-	_channels[channel].SetPassword(password);
+void Server::_changePasswordRestriction(Channel &channel, std::string password) {
+	channel.SetPassword(password);
+	if (_bus) {
+		_bus->ChangeChannel(channel.GetName(), [&](ChannelState &state) {
+			state.key = password;
+		});
+	}
 }
 
-// changes the operator privileges of a channel
-void Server::_changeOperatorPrivileges(std::string channel, std::string user, bool isOperator) {
+// changes the operator privileges of a channel, false if no client has that nick
+bool Server::_changeOperatorPrivileges(Channel &channel, std::string user, bool isOperator) {
 	int userFd = _findClientFromNickname(user);
+	// a member connected to another shard gets its status from that shard
 	if (userFd == -1) {
-		throw std::runtime_error("User not found");
-	}
-	if (isOperator) {
-		_channels[channel].MakeOperator(userFd);
+		if (!_relayChannelOperator(channel.GetName(), user, isOperator)) {
+			return false;
+		}
+	} else if (isOperator) {
+		channel.MakeOperator(_clients.GetHandle(userFd));
 	} else {
-		_channels[channel].RemoveOperator(userFd);
+		channel.RemoveOperator(userFd);
+	}
+	// NAMES on every shard reads the status from the channel directory
+	if (_bus) {
+		_bus->SetMemberOperator(channel.GetName(), user, isOperator);
 	}
+	return true;
 }
 
 // changes the user limit restriction of a channel
-void Server::_changeUserLimitRestriction(std::string channel, size_t userLimit) {
-	_channels[channel].SetUserLimit(userLimit);
+void Server::_changeUserLimitRestriction(Channel &channel, size_t userLimit) {
+	channel.SetUserLimit(userLimit);
+	if (_bus) {
+		_bus->ChangeChannel(channel.GetName(), [&](ChannelState &state) {
+			state.userLimit = userLimit;
+		});
+	}
 }
 
 // changes the invite only restriction of a channel
-void Server::_changeInviteOnlyRestriction(std::string channel, bool flag) {
-	_channels[channel].SetInviteOnly(flag);
+void Server::_changeInviteOnlyRestriction(Channel &channel, bool flag) {
+	channel.SetInviteOnly(flag);
+	if (_bus) {
+		_bus->ChangeChannel(channel.GetName(), [&](ChannelState &state) {
+			state.inviteOnly = flag;
+		});
+	}
 }
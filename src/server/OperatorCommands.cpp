@@ -12,8 +12,7 @@
 void Server::Kick(int clientSocket, const std::vector<std::string>& tokens) {
 	// Need at least channel + user.
 	if (tokens.size() < 2) {
-		std::string err = ":" + _clients[clientSocket].GetNickName() + " 461 KICK :Not enough parameters\r\n";
-		send(clientSocket, err.c_str(), err.size(), 0);
+		_reply(clientSocket, ERR_NEEDMOREPARAMS, {"KICK"});
 		return;
 	}
 	std::string channelName = tokens[0];
@@ -25,46 +24,45 @@ void Server::Kick(int clientSocket, const std::vector<std::string>& tokens) {
 	}
 
 	// Confirm channel exists.
-	if (_channels.find(channelName) == _channels.end()) {
-		std::string err = ":" + _clients[clientSocket].GetNickName() + " 404 " + channelName + " :No such channel\r\n";
-		send(clientSocket, err.c_str(), err.size(), 0);
+	Channel *found = _findChannel(channelName);
+	if (!found) {
+		_reply(clientSocket, ERR_NOSUCHCHANNEL, {channelName});
 		return;
 	}
-	Channel &channel = _channels[channelName];
+	Channel &channel = *found;
 
 	// Confirm user is an operator in the channel.
-	if (std::find(channel.GetOperators().begin(), channel.GetOperators().end(), clientSocket) == channel.GetOperators().end()) {
-		std::string err = ":" + _clients[clientSocket].GetNickName() + " 482 " + channelName + " :You're not channel operator\r\n";
-		send(clientSocket, err.c_str(), err.size(), 0);
+	if (!channel.IsUserOperator(_clients.GetHandle(clientSocket))) {
+		_reply(clientSocket, ERR_CHANOPRIVSNEEDED, {channelName});
 		return;
 	}
 
-	if (userName == _clients[clientSocket].GetNickName()) {
-		std::string err = ":" + _clients[clientSocket].GetNickName() + " 417 :You cannot kick yourself\r\n";
-		send(clientSocket, err.c_str(), err.size(), 0);
+	if (CaseMapping::Equals(userName, _clients[clientSocket].GetNickName())) {
+		_reply(clientSocket, ERR_UNKNOWNERROR, {"KICK", "You cannot kick yourself"});
 		return;
 	}
 
 	// Look up the user’s FD by nickname.
 	int userFd = _findClientFromNickname(userName);
-	if (userFd == -1 || std::find(channel.GetUsers().begin(), channel.GetUsers().end(), userFd) == channel.GetUsers().end()) {
-		std::string err = ":" + _clients[clientSocket].GetNickName() + " 441 " + userName + " :They aren't in the channel\r\n";
-		send(clientSocket, err.c_str(), err.size(), 0);
+	std::string_view kickMsg = _userMessage(clientSocket, {"KICK ", channelName, " ", userName, " :", reason});
+	// A user connected to another shard is kicked by its own shard if it is a member there.
+	if (userFd == -1 && _relayToNickShard(SHARD_CHANNEL_KICK, channelName, userName, kickMsg)) {
+		return;
+	}
+	if (userFd == -1 || !_clients[userFd].IsInChannel(channelName)) {
+		_reply(clientSocket, ERR_USERNOTINCHANNEL, {userName, channelName});
 		return;
 	}
 
 	// Notify the kicked user.
-	std::string kickMsg = ":" + _clients[clientSocket].GetNickName() + " KICK " + channelName + " " + userName + " :" + reason + "\r\n";
-	send(userFd, kickMsg.c_str(), kickMsg.size(), 0);
+	_sendToClient(userFd, kickMsg);
 
 	// Remove the user from the channel.
-	channel.RemoveUser(userFd);
+	_removeChannelMember(channel, userFd);
 
 	// Broadcast to remaining channel members.
-	for (int memberFd : channel.GetUsers()) {
-		if (memberFd != userFd)
-			send(memberFd, kickMsg.c_str(), kickMsg.size(), 0);
-	}
+	_deliverToChannel(channel, kickMsg, userFd);
+	_relayChannelLine(channelName, kickMsg);
 }
 
 // invites a user to a channel
@@ -74,13 +72,8 @@ void Server::Invite(int clientSocket, const std::vector<std::string>& tokens) {
 	*   /invite <nickname> <channel> -> Invite a user to a channel
 	*/
 
-	// placeholder for the server name
-	std::string serverName = "my.irc.server";
-
 	if (tokens.size() != 2) {
-		std::string err = ":" + serverName + " 461 " +
-						_clients[clientSocket].GetNickName() + " INVITE :Not enough parameters\r\n";
-		send(clientSocket, err.c_str(), err.size(), 0);
+		_reply(clientSocket, ERR_NEEDMOREPARAMS, {"INVITE"});
 		return;
 	}
 
@@ -88,51 +81,48 @@ void Server::Invite(int clientSocket, const std::vector<std::string>& tokens) {
 	std::string channelName = tokens[1];
 
 	// 1) Check whether channel exists
-	if (_channels.find(channelName) == _channels.end()) {
-		std::string err = ":" + serverName + " 403 " +
-						_clients[clientSocket].GetNickName() + " " + channelName + " :No such channel\r\n";
-		send(clientSocket, err.c_str(), err.size(), 0);
+	Channel *found = _findChannel(channelName);
+	if (!found) {
+		_reply(clientSocket, ERR_NOSUCHCHANNEL, {channelName});
 		return;
 	}
 
 	// 2) Check whether target user exists
 	int targetFd = _findClientFromNickname(targetNick);
-	if (targetFd == -1) {
-		std::string err = ":" + serverName + " 401 " +
-						_clients[clientSocket].GetNickName() + " " + targetNick + " :No such nick\r\n";
-		send(clientSocket, err.c_str(), err.size(), 0);
+	if (targetFd == -1 && (!_bus || _bus->FindNick(targetNick) == -1)) {
+		_reply(clientSocket, ERR_NOSUCHNICK, {targetNick});
 		return;
 	}
 
-	Channel &channel = _channels[channelName];
+	Channel &channel = *found;
 
 	// 3) Check whether client is channel operator
-	if (std::find(channel.GetOperators().begin(), channel.GetOperators().end(), clientSocket) == channel.GetOperators().end()) {
-		std::string err = ":" + serverName + " 482 " +
-						_clients[clientSocket].GetNickName() + " " + channelName + " :You're not channel operator\r\n";
-		send(clientSocket, err.c_str(), err.size(), 0);
+	if (!channel.IsUserOperator(_clients.GetHandle(clientSocket))) {
+		_reply(clientSocket, ERR_CHANOPRIVSNEEDED, {channelName});
+		return;
+	}
+
+	std::string_view inviteMsg = _userMessage(clientSocket, {"INVITE ", targetNick, " ", channelName});
+
+	// A user connected to another shard is put on that shard's invite list.
+	if (targetFd == -1) {
+		_relayToNickShard(SHARD_CHANNEL_INVITE, channelName, targetNick, inviteMsg);
+		_reply(clientSocket, RPL_INVITING, {targetNick, channelName});
 		return;
 	}
 
 	// 4) Check if the target user is already in the channel
-	const std::vector<int>& users = channel.GetUsers();
-	if (std::find(users.begin(), users.end(), targetFd) != users.end()) {
-		std::string err = ":" + serverName
-						  + " 443 " + _clients[targetFd].GetNickName() + " " + channelName +
-						  " :is already on channel\r\n";
-		send(clientSocket, err.c_str(), err.size(), 0);
+	if (_clients[targetFd].IsInChannel(channelName)) {
+		_reply(clientSocket, ERR_USERONCHANNEL, {_clients[targetFd].GetNickName(), channelName});
 		return;
 	}
 
 //	// 5) Add the target user to the invited list if not already present.
-	std::vector<int>& invited = channel.GetInvited();
-	if (std::find(invited.begin(), invited.end(), targetFd) == invited.end()) {
-		invited.push_back(targetFd);
-	}
+	channel.Invite(_clients.GetHandle(targetFd));
 
 //	6) send invite message to target user
-	std::string inviteMsg = ":" + _clients[clientSocket].GetNickName() + " INVITE " + targetNick + " " + channelName + "\r\n";
-	send(targetFd, inviteMsg.c_str(), inviteMsg.size(), 0);
+	_sendToClient(targetFd, inviteMsg);
+	_reply(clientSocket, RPL_INVITING, {_clients[targetFd].GetNickName(), channelName});
 }
 
 // sets the topic of a channel
@@ -143,68 +133,43 @@ void Server::Topic(int clientSocket, const std::vector<std::string>& tokens) {
 	*   /topic <channel> :<topic> -> Set channel’s topic
 	*/
 
-	// Set up a "server name" for numeric replies (could match your actual hostname/IP).
-	std::string serverName = "127.0.0.1:6667";
+	if (tokens.empty()) {
+		_reply(clientSocket, ERR_NEEDMOREPARAMS, {"TOPIC"});
+		return;
+	}
 	std::string channelName = tokens[0];
 
 	// 1) Check whether channel exists
-	if (_channels.find(channelName) == _channels.end()) {
-		std::string err = ":" + serverName + " 403 " +
-						_clients[clientSocket].GetNickName() + " " + channelName + " :No such channel\r\n";
-		send(clientSocket, err.c_str(), err.size(), 0);
+	Channel *found = _findChannel(channelName);
+	if (!found) {
+		_reply(clientSocket, ERR_NOSUCHCHANNEL, {channelName});
 		return;
 	}
-	Channel &channel = _channels[channelName];
+	Channel &channel = *found;
 
 	// 2) Check if user is in the channel
-	if (std::find(channel.GetUsers().begin(), channel.GetUsers().end(), clientSocket) == channel.GetUsers().end()) {
-		std::string err = ":" + serverName + " 442 " +
-						_clients[clientSocket].GetNickName() + " " + channelName + " :You're not on that channel\r\n";
-		send(clientSocket, err.c_str(), err.size(), 0);
+	if (!_clients[clientSocket].IsInChannel(channelName)) {
+		_reply(clientSocket, ERR_NOTONCHANNEL, {channelName});
 		return;
 	}
 
 	// 3) If no extra topic text, show the current topic
 	if (tokens.size() == 1) {
-		if (channel.GetTopic().empty()) {
-			// 331: RPL_NOTOPIC
-			std::string rplNoTopic = ":" + serverName + " 331 " +
-									_clients[clientSocket].GetNickName() + " " + channelName +
-									" :No topic is set\r\n";
-			send(clientSocket, rplNoTopic.c_str(), rplNoTopic.size(), 0);
-		} else {
-			// 332: RPL_TOPIC
-			std::string rplTopic = ":" + serverName + " 332 " +
-								_clients[clientSocket].GetNickName() + " " + channelName +
-								" :" + channel.GetTopic() + "\r\n";
-			send(clientSocket, rplTopic.c_str(), rplTopic.size(), 0);
-
-			// 333: RPL_TOPICWHOTIME (Optional but many clients expect it)
-			// Format: "<nick> <channel> <whoSetTopic> <when>"
-			std::string rplTopicWhoTime = ":" + serverName + " 333 " +
-										_clients[clientSocket].GetNickName() + " " + channelName + " " +
-										channel.GetTopicSetBy() + " " +
-										std::to_string(channel.GetTopicSetTime()) + "\r\n";
-			send(clientSocket, rplTopicWhoTime.c_str(), rplTopicWhoTime.size(), 0);
-		}
+		_replyTopic(clientSocket, channel);
 		return;
 	}
 
 	// 4) If there is a topic text to set, require operator status (or check +t mode if you have it)
-	if (channel.GetTopicOnlySettableByOperator() &&
-    std::find(channel.GetOperators().begin(), channel.GetOperators().end(), clientSocket) == channel.GetOperators().end()) {
-		std::string err = ":" + serverName + " 482 " +
-						_clients[clientSocket].GetNickName() + " " + channelName +
-						" :You're not channel operator\r\n";
-		send(clientSocket, err.c_str(), err.size(), 0);
+	if (_isTopicRestricted(channel) && !channel.IsUserOperator(_clients.GetHandle(clientSocket))) {
+		_reply(clientSocket, ERR_CHANOPRIVSNEEDED, {channelName});
 		return;
 	}
 
 	// 5) Gather the topic text
-	std::string newTopic;
-	std::string sanitized;
+	ArenaString sanitized(_arena);
+	ArenaString token(_arena);
 	for (size_t i = 1; i < tokens.size(); i++) {
-		std::string token = tokens[i];
+		token.assign(tokens[i].data(), tokens[i].size());
 		// If this is the first token, remove a leading ':' if present.
 		if (i == 1 && !token.empty() && token[0] == ':') {
 			token.erase(0, 1);
@@ -227,23 +192,20 @@ void Server::Topic(int clientSocket, const std::vector<std::string>& tokens) {
 			sanitized.append(token);
 		}
 	}
-	newTopic = sanitized;
+	std::string_view newTopic = sanitized;
 	if (!newTopic.empty() && newTopic[0] == ':') {
-		newTopic.erase(0, 1);
+		newTopic.remove_prefix(1);
 	}
 
 	// 6) Record who set the topic and when (if you store it in Channel)
-	channel.SetTopic(newTopic);
+	channel.SetTopic(std::string(newTopic));
 	channel.SetTopicSetBy(_clients[clientSocket].GetNickName());
 	channel.SetTopicSetTime(std::time(nullptr));
 
 	// 7) Broadcast the new topic to everyone in the channel
-	std::string prefix = _clients[clientSocket].GetNickName() + "!" +
-						_clients[clientSocket].GetUserName() + "@127.0.0.1";  // your server's userhost
-	std::string topicBroadcast = ":" + prefix + " TOPIC " + channelName + " :" + newTopic + "\r\n";
+	std::string_view topicBroadcast = _userMessage(clientSocket, {"TOPIC ", channelName, " :", newTopic});
 
-	for (int userFd : channel.GetUsers()) {
-		send(userFd, topicBroadcast.c_str(), topicBroadcast.size(), 0);
-	}
+	_deliverToChannel(channel, topicBroadcast, -1);
+	_relayChannelTopic(channel, topicBroadcast);
 }
 
@@ -13,7 +13,15 @@ Server* Server::_instance = nullptr;
 /* --------------------------------------------------------------------------------- */
 /* Constructors & Destructors                                                        */
 /* --------------------------------------------------------------------------------- */
-Server::Server(uint16_t port, std::string password) : _host("0.0.0.0"), _port(port), _password(password), _running(true) {
+Server::Server(uint16_t port, std::string password, const ServerConfig &config, ShardBus *bus, size_t shardId)
+	: _host("0.0.0.0"), _port(port), _password(password), _acceptRetryAt(0), _running(true), _config(config),
+	_replies(config.serverName), _bus(bus), _shardId(shardId), _wakeFd(-1), _admission(config.maxPerIp, config.connectRate),
+	_maxClients(config.maxClients), _spareFd(-1), _sendqStats(), _nowMs(0), _wallMs(0),
+	_msgidCounter(0), _historyBatches(0) {
+	_updateClock();
+	// ids of a previous run are lower unless it averaged more than one message per millisecond
+	_msgidCounter = static_cast<uint64_t>(_wallMs);
+	_timers.Start(_nowMs);
 	//	open socket
 	_socket = socket(AF_INET, SOCK_STREAM, 0);
 	if (_socket == -1) {
@@ -22,6 +30,13 @@ Server::Server(uint16_t port, std::string password) : _host("0.0.0.0"), _port(po
 
 //	set socket options
 	fcntl(_socket, F_SETFL, O_NONBLOCK);
+#ifdef SO_REUSEPORT
+//	every shard binds its own listening socket, the kernel spreads connections across them
+	if (_bus) {
+		int enable = 1;
+		setsockopt(_socket, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable));
+	}
+#endif
 
 	struct addrinfo hints;
 	std::memset(&hints, 0, sizeof(hints));
@@ -55,25 +70,68 @@ Server::Server(uint16_t port, std::string password) : _host("0.0.0.0"), _port(po
 	// Make _listeningFd point to the same socket
 	_listeningFd = _socket;
 
-	//	initialize pollfd vector
-	_pollFds.push_back({_socket, POLLIN, 0});
+//	split the client cap between shards, derive it from the fd limit if not configured
+	if (_maxClients == 0) {
+		struct rlimit limit;
+		if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY && limit.rlim_cur > RESERVED_FDS) {
+			_maxClients = static_cast<size_t>(limit.rlim_cur) - RESERVED_FDS;
+		}
+	}
+	if (_maxClients > 0) {
+		_maxClients = (_maxClients + _config.threads - 1) / _config.threads;
+	}
+	_spareFd = open("/dev/null", O_RDONLY);
+
+//	initialize io_uring if requested, falls back to epoll when the kernel lacks it
+	if (_config.backend == POLLER_URING) {
+		try {
+			_uring.reset(new IoUring());
+		} catch (std::exception &e) {
+			std::cerr << e.what() << ", falling back to epoll" << std::endl;
+			_config.backend = POLLER_EPOLL;
+		}
+	}
+	if (_bus) {
+		_wakeFd = _bus->GetWakeFd(_shardId);
+	}
+
+//	initialize readiness backend, the listening socket stays level triggered
+	if (!_uring) {
+		_poller.reset(Poller::Create(_config.backend));
+		if (!_poller->Add(_socket, POLLER_READ, false)) {
+			close(_socket);
+			throw std::runtime_error("Failed to register listening socket");
+		}
+
+//		other shards wake this event loop through the mailbox pipe
+		if (_wakeFd != -1 && !_poller->Add(_wakeFd, POLLER_READ, false)) {
+			close(_socket);
+			throw std::runtime_error("Failed to register shard mailbox");
+		}
+	}
 
 	// Print server start message
-	std::cout << "Server running on " << _host << ":" << _port << std::endl;
-
-//	initialize function mapping
-	_methods.emplace(AUTHENTICATE, static_cast<void (Server::*)(int, const std::vector<std::string>&)>(&Server::Authenticate));
-	_methods.emplace(NICK,         static_cast<void (Server::*)(int, const std::vector<std::string>&)>(&Server::Nick));
-	_methods.emplace(USER,         static_cast<void (Server::*)(int, const std::vector<std::string>&)>(&Server::User));
-	_methods.emplace(JOIN,         static_cast<void (Server::*)(int, const std::vector<std::string>&)>(&Server::Join));
-	_methods.emplace(MSG,          static_cast<void (Server::*)(int, const std::vector<std::string>&)>(&Server::PrivMsg));
-	_methods.emplace(KICK,         static_cast<void (Server::*)(int, const std::vector<std::string>&)>(&Server::Kick));
-	_methods.emplace(INVITE,       static_cast<void (Server::*)(int, const std::vector<std::string>&)>(&Server::Invite));
-	_methods.emplace(TOPIC,        static_cast<void (Server::*)(int, const std::vector<std::string>&)>(&Server::Topic));
-	_methods.emplace(MODE,         static_cast<void (Server::*)(int, const std::vector<std::string>&)>(&Server::Mode));
-	_methods.emplace(PING,         static_cast<void (Server::*)(int, const std::vector<std::string>&)>(&Server::Ping));
-	_methods.emplace(QUIT,         static_cast<void (Server::*)(int, const std::vector<std::string>&)>(&Server::Quit));
-	_methods.emplace(INVALID,      nullptr);
+	if (_shardId == 0) {
+		std::cout << "Server running on " << _host << ":" << _port << " (" << GetBackendName()
+			<< ", " << _config.threads << (_config.threads == 1 ? " thread" : " threads") << ")" << std::endl;
+	}
+
+//	initialize function mapping, indexed by the method the parser returns
+	std::fill(_methods, _methods + INVALID + 1, static_cast<CommandHandler>(nullptr));
+	_methods[AUTHENTICATE] = static_cast<CommandHandler>(&Server::Authenticate);
+	_methods[NICK]         = static_cast<CommandHandler>(&Server::Nick);
+	_methods[USER]         = static_cast<CommandHandler>(&Server::User);
+	_methods[JOIN]         = static_cast<CommandHandler>(&Server::Join);
+	_methods[MSG]          = static_cast<CommandHandler>(&Server::PrivMsg);
+	_methods[KICK]         = static_cast<CommandHandler>(&Server::Kick);
+	_methods[INVITE]       = static_cast<CommandHandler>(&Server::Invite);
+	_methods[TOPIC]        = static_cast<CommandHandler>(&Server::Topic);
+	_methods[MODE]         = static_cast<CommandHandler>(&Server::Mode);
+	_methods[PING]         = static_cast<CommandHandler>(&Server::Ping);
+	_methods[PONG]         = static_cast<CommandHandler>(&Server::Pong);
+	_methods[QUIT]         = static_cast<CommandHandler>(&Server::Quit);
+	_methods[STATS]        = static_cast<CommandHandler>(&Server::Stats);
+	_methods[CHATHISTORY]  = static_cast<CommandHandler>(&Server::ChatHistory);
 
 //	initialize parser
 	_parser = Parser();
@@ -104,9 +162,19 @@ int Server::GetSocket() const {
 	return _socket;
 }
 
-// returns the pollfd vector
-std::vector<pollfd> Server::GetPollFds() const {
-	return _pollFds;
+// returns the index of this event loop among all shards
+size_t Server::GetShardId() const {
+	return _shardId;
+}
+
+// returns the connection admission counters
+const AdmissionStats& Server::GetAdmissionStats() const {
+	return _admission.GetStats();
+}
+
+// returns the name of the I/O backend in use
+const char* Server::GetBackendName() const {
+	return _uring ? "io_uring" : _poller->GetName();
 }
 
 /* --------------------------------------------------------------------------------- */
@@ -114,31 +182,54 @@ std::vector<pollfd> Server::GetPollFds() const {
 /* --------------------------------------------------------------------------------- */
 // runs the server
 bool Server::Run() {
+	if (_uring) {
+		return RunUring();
+	}
+	std::vector<PollerEvent> events;
 	while (_running) {
-		int pollCount = poll(_pollFds.data(), _pollFds.size(), -1);
-		if (pollCount < 0) {
+		int eventCount = _poller->Wait(events, _timers.GetTimeout(_nowMs));
+		if (eventCount < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
 			// handle error
 			return false;
 		}
+		_updateClock();
 
-		std::vector<int> toRemove;
-		for (size_t i = 0; i < _pollFds.size(); ++i) {
-			if (_pollFds[i].revents & POLLIN) {
-				if (_pollFds[i].fd == _listeningFd) {
-					HandleNewConnection();
-				} else {
-					if (!HandleClient(_pollFds[i].fd)) {
-						toRemove.push_back(_pollFds[i].fd);
-					}
+		for (size_t i = 0; i < events.size(); ++i) {
+			int fd = events[i].fd;
+			if (fd == _listeningFd) {
+				HandleNewConnection();
+				continue;
+			}
+			if (fd == _wakeFd) {
+				HandleShardMessages();
+				continue;
+			}
+			// client may have been disconnected by an earlier event of this batch
+			if (!_clients.Contains(fd)) {
+				continue;
+			}
+			if ((events[i].events & POLLER_WRITE) && !FlushClient(fd)) {
+				_scheduleDisconnect(fd);
+				continue;
+			}
+			if (events[i].events & (POLLER_READ | POLLER_CLOSE)) {
+				if (!HandleClient(fd)) {
+					_scheduleDisconnect(fd);
 				}
 			}
-			// optionally handle other events like POLLOUT
 		}
 
-		// Remove closed/disconnected FDs here
-		for (size_t i = 0; i < toRemove.size(); ++i) {
-			RemoveClient(toRemove[i]);
-		}
+		// Keepalive PINGs & timeouts that are due
+		_runTimers();
+
+		// Send everything this iteration produced & remove closed/disconnected FDs, never in the middle of a handler
+		_settlePending();
+
+		// Every command scoped temporary of this iteration is dead now
+		_arena.Reset();
 	}
 	return true;
 }
@@ -165,14 +256,20 @@ void Server::Cleanup() {
 	_running = false;
 	
 	// Close all client connections
-	for (const auto& client : _clients) {
-		close(client.first);
+	for (int clientFd : _clients.GetFds()) {
+		if (_poller) {
+			_poller->Remove(clientFd);
+		}
+		close(clientFd);
 	}
 	
 	// Close server socket
 	if (_socket != -1) {
 		close(_socket);
 	}
+	if (_spareFd != -1) {
+		close(_spareFd);
+	}
 	
 	std::cout << "Server shutdown complete." << std::endl;
 }
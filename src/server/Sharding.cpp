@@ -0,0 +1,218 @@
+//
+// Created on 10/18/26.
+//
+
+#include "Server.hpp"
+
+/* --------------------------------------------------------------------------------- */
+/* Cross Shard Delivery                                                              */
+/* --------------------------------------------------------------------------------- */
+// handles everything other shards posted to this event loop
+void Server::HandleShardMessages() {
+	std::vector<ShardMessage> messages;
+	_bus->Drain(_shardId, messages);
+	for (size_t i = 0; i < messages.size(); ++i) {
+		const ShardMessage &msg = messages[i];
+		Channel *channel = _findChannel(msg.channel);
+		switch (msg.type) {
+			case SHARD_CHANNEL_LINE:
+				if (channel) {
+					_deliverToChannel(*channel, msg.line, -1, msg.priority);
+				}
+				break;
+			case SHARD_USER_LINE:
+			{
+				int clientFd = _findClientFromNickname(msg.nick);
+				if (clientFd != -1) {
+					_sendToClient(clientFd, msg.line);
+				}
+				break;
+			}
+			case SHARD_CHANNEL_TOPIC:
+				if (channel) {
+					channel->SetTopic(msg.topic);
+					channel->SetTopicSetBy(msg.topicSetBy);
+					channel->SetTopicSetTime(msg.topicSetTime);
+					_deliverToChannel(*channel, msg.line, -1);
+				}
+				break;
+			case SHARD_CHANNEL_KICK:
+			{
+				// the kick only happens if the user is a member on this shard
+				int clientFd = _findClientFromNickname(msg.nick);
+				if (clientFd == -1 || !channel) {
+					break;
+				}
+				if (!_clients[clientFd].IsInChannel(msg.channel)) {
+					break;
+				}
+				_deliverToChannel(*channel, msg.line, -1);
+				_removeChannelMember(*channel, clientFd);
+				_relayChannelLine(msg.channel, msg.line);
+				break;
+			}
+			case SHARD_CHANNEL_INVITE:
+			{
+				int clientFd = _findClientFromNickname(msg.nick);
+				if (clientFd == -1) {
+					break;
+				}
+				// the invite has to outlast the join, so the channel gets a local copy if it has none yet
+				ChannelState state;
+				if (!channel && _bus->FindChannel(msg.channel, state)) {
+					channel = &_localChannel(state);
+				}
+				if (channel) {
+					channel->Invite(_clients.GetHandle(clientFd));
+				}
+				_sendToClient(clientFd, msg.line);
+				break;
+			}
+			case SHARD_CHANNELS_LINE:
+				_deliverToChannels(msg.channels, msg.line, -1);
+				break;
+			case SHARD_CHANNEL_OPERATOR:
+			{
+				int clientFd = _findClientFromNickname(msg.nick);
+				if (clientFd == -1 || !channel || !_clients[clientFd].IsInChannel(msg.channel)) {
+					break;
+				}
+				if (msg.operatorStatus) {
+					channel->MakeOperator(_clients.GetHandle(clientFd));
+				} else {
+					channel->RemoveOperator(clientFd);
+				}
+				break;
+			}
+		}
+	}
+}
+
+// sends a line to the local members of a channel, except one
+void Server::_deliverToChannel(const Channel &channel, std::string_view msg, int exceptFd, SendPriority priority) {
+	// encoded once, every member queues a reference
+	SendBuffer buffer(msg);
+	for (const ChannelMember &member : channel.GetMembers()) {
+		if (member.fd != exceptFd) {
+			_sendToClient(member.fd, buffer, priority);
+		}
+	}
+}
+
+// sends a line once to the local members of several channels & to extraFd, except one
+void Server::_deliverToChannels(const std::vector<std::string> &channelNames, std::string_view msg, int exceptFd,
+	int extraFd) {
+	std::vector<int> recipients;
+	if (extraFd != -1) {
+		recipients.push_back(extraFd);
+	}
+	for (size_t i = 0; i < channelNames.size(); ++i) {
+		const Channel *channel = _findChannel(channelNames[i]);
+		if (channel) {
+			for (const ChannelMember &member : channel->GetMembers()) {
+				recipients.push_back(member.fd);
+			}
+		}
+	}
+	// members sharing several channels get the line once
+	std::sort(recipients.begin(), recipients.end());
+	recipients.erase(std::unique(recipients.begin(), recipients.end()), recipients.end());
+	SendBuffer buffer(msg);
+	for (size_t i = 0; i < recipients.size(); ++i) {
+		if (recipients[i] != exceptFd) {
+			_sendToClient(recipients[i], buffer);
+		}
+	}
+}
+
+// forwards a line for the members of several channels to the shards with members in them, once per shard
+void Server::_relayChannelsLine(const std::vector<std::string> &channelNames, std::string_view line) {
+	if (!_bus || channelNames.empty()) {
+		return;
+	}
+	ShardMessage msg;
+	msg.type = SHARD_CHANNELS_LINE;
+	msg.channels = channelNames;
+	msg.line.assign(line.data(), line.size());
+	msg.topicSetTime = 0;
+	_bus->PostToChannelShards(_shardId, msg);
+}
+
+// forwards a channel line to the other shards with members in it
+void Server::_relayChannelLine(const std::string &channelName, std::string_view line, SendPriority priority) {
+	if (!_bus) {
+		return;
+	}
+	ShardMessage msg;
+	msg.type = SHARD_CHANNEL_LINE;
+	msg.channel = channelName;
+	msg.line.assign(line.data(), line.size());
+	msg.topicSetTime = 0;
+	msg.priority = priority;
+	_bus->PostToChannelShards(_shardId, msg);
+}
+
+// forwards a line to a nickname connected to another shard, false if nobody uses it
+bool Server::_relayUserLine(const std::string &nickname, std::string_view line) {
+	return _relayToNickShard(SHARD_USER_LINE, "", nickname, line);
+}
+
+// posts a message to the shard owning a nickname, false if no other shard owns it
+bool Server::_relayToNickShard(ShardMessageType type, const std::string &channelName, const std::string &nickname,
+	std::string_view line) {
+	if (!_bus) {
+		return false;
+	}
+	ShardMessage msg;
+	msg.type = type;
+	msg.channel = channelName;
+	msg.nick = nickname;
+	msg.line.assign(line.data(), line.size());
+	msg.topicSetTime = 0;
+	return _postToNickShard(msg);
+}
+
+// gives or takes the operator status of a member connected to another shard, false if no other shard owns the nick
+bool Server::_relayChannelOperator(const std::string &channelName, const std::string &nickname, bool isOperator) {
+	if (!_bus) {
+		return false;
+	}
+	ShardMessage msg;
+	msg.type = SHARD_CHANNEL_OPERATOR;
+	msg.channel = channelName;
+	msg.nick = nickname;
+	msg.topicSetTime = 0;
+	msg.operatorStatus = isOperator;
+	return _postToNickShard(msg);
+}
+
+// posts a message to the shard owning msg.nick, false if no other shard owns it
+bool Server::_postToNickShard(const ShardMessage &msg) {
+	int shard = _bus->FindNick(msg.nick);
+	if (shard == -1 || static_cast<size_t>(shard) == _shardId) {
+		return false;
+	}
+	_bus->Post(static_cast<size_t>(shard), msg);
+	return true;
+}
+
+// forwards a topic change so other shards with members update their copy of the channel
+void Server::_relayChannelTopic(Channel &channel, std::string_view line) {
+	if (!_bus) {
+		return;
+	}
+	// channels created on a shard later on start out with this topic
+	_bus->ChangeChannel(channel.GetName(), [&](ChannelState &state) {
+		state.topic = channel.GetTopic();
+		state.topicSetBy = channel.GetTopicSetBy();
+		state.topicSetTime = channel.GetTopicSetTime();
+	});
+	ShardMessage msg;
+	msg.type = SHARD_CHANNEL_TOPIC;
+	msg.channel = channel.GetName();
+	msg.line.assign(line.data(), line.size());
+	msg.topic = channel.GetTopic();
+	msg.topicSetBy = channel.GetTopicSetBy();
+	msg.topicSetTime = channel.GetTopicSetTime();
+	_bus->PostToChannelShards(_shardId, msg);
+}
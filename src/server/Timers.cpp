@@ -0,0 +1,83 @@
+//
+// Created on 10/18/26.
+//
+
+#include "Server.hpp"
+
+/* --------------------------------------------------------------------------------- */
+/* Clock                                                                             */
+/* --------------------------------------------------------------------------------- */
+// reads the monotonic clock once per loop iteration
+void Server::_updateClock() {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	_nowMs = static_cast<uint64_t>(now.tv_sec) * 1000 + static_cast<uint64_t>(now.tv_nsec) / 1000000;
+	clock_gettime(CLOCK_REALTIME, &now);
+	_wallMs = static_cast<int64_t>(now.tv_sec) * 1000 + now.tv_nsec / 1000000;
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Timers                                                                            */
+/* --------------------------------------------------------------------------------- */
+// runs every client timer that expired since the last iteration
+void Server::_runTimers() {
+	_expiredTimers.clear();
+	_timers.Advance(_nowMs, _expiredTimers);
+	for (size_t i = 0; i < _expiredTimers.size(); ++i) {
+		_handleClientTimer(_expiredTimers[i]);
+	}
+}
+
+// a client has a single timer, what it means depends on the client's state
+void Server::_handleClientTimer(int clientFd) {
+	Client *found = _clients.Find(clientFd);
+	if (!found || found->GetSendqExceeded()) {
+		return;
+	}
+	Client &client = *found;
+
+	// registration deadline
+	if (!client.GetRegistered() && _config.registrationTimeout > 0) {
+		_sendToClient(clientFd, "ERROR :Closing Link: (Registration timed out)\r\n");
+		_scheduleDisconnect(clientFd);
+		return;
+	}
+	if (_config.pingInterval == 0) {
+		return;
+	}
+
+	// PONG deadline, any line received since the PING proves the link is alive, none without a ping timeout
+	if (client.GetPingSentAt() != 0 && _config.pingTimeout > 0) {
+		if (client.GetLastActivity() < client.GetPingSentAt()) {
+			_sendToClient(clientFd, "ERROR :Closing Link: (Ping timeout: " +
+				std::to_string(_config.pingTimeout) + " seconds)\r\n");
+			_scheduleDisconnect(clientFd);
+			return;
+		}
+		client.SetPingSentAt(0);
+	}
+
+	// keepalive, only silent clients are pinged
+	uint64_t pingAt = client.GetLastActivity() + _config.pingInterval * 1000;
+	if (_nowMs < pingAt) {
+		_timers.Schedule(clientFd, pingAt);
+		return;
+	}
+	_sendToClient(clientFd, _arena.Concat({"PING :", _replies.GetServerName(), "\r\n"}));
+	client.SetPingSentAt(_nowMs);
+	// without a ping timeout the PING only measures the round trip, the next keepalive check is a ping interval away
+	if (_config.pingTimeout > 0) {
+		_timers.Schedule(clientFd, _nowMs + _config.pingTimeout * 1000);
+	} else {
+		_timers.Schedule(clientFd, _nowMs + _config.pingInterval * 1000);
+	}
+}
+
+// arms the first timer of a new client
+void Server::_startClientTimer(int clientFd) {
+	if (_config.registrationTimeout > 0) {
+		_timers.Schedule(clientFd, _nowMs + _config.registrationTimeout * 1000);
+	} else if (_config.pingInterval > 0) {
+		_timers.Schedule(clientFd, _nowMs + _config.pingInterval * 1000);
+	}
+}
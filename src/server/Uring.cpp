@@ -0,0 +1,201 @@
+//
+// Created on 10/18/26.
+//
+
+#include "Server.hpp"
+
+/* --------------------------------------------------------------------------------- */
+/* io_uring Event Loop                                                               */
+/* --------------------------------------------------------------------------------- */
+// user data layout: operation (8 bits) | fd generation (24 bits) | fd (32 bits)
+static UringOperation _userDataOperation(uint64_t userData) {
+	return static_cast<UringOperation>(userData >> 56);
+}
+
+static uint32_t _userDataGeneration(uint64_t userData) {
+	return static_cast<uint32_t>(userData >> 32) & 0xFFFFFF;
+}
+
+static int _userDataFd(uint64_t userData) {
+	return static_cast<int>(userData & 0xFFFFFFFF);
+}
+
+// tags a request with its operation & the current generation of the fd
+uint64_t Server::_uringUserData(UringOperation op, int fd) const {
+	uint64_t generation = 0;
+	if (fd >= 0 && static_cast<size_t>(fd) < _uringSlots.size()) {
+		generation = _uringSlots[fd].generation & 0xFFFFFF;
+	}
+	return (static_cast<uint64_t>(op) << 56) | (generation << 32) | static_cast<uint32_t>(fd);
+}
+
+// runs the server on io_uring: multishot accept & recv, linked sends
+bool Server::RunUring() {
+	_uring->PrepareMultishotAccept(_listeningFd, _uringUserData(URING_OP_ACCEPT, _listeningFd));
+	if (_wakeFd != -1) {
+		_uring->PrepareMultishotPoll(_wakeFd, _uringUserData(URING_OP_WAKE, _wakeFd));
+	}
+
+	std::vector<IoCompletion> completions;
+	while (_running) {
+		int timeout = _timers.GetTimeout(_nowMs);
+		if (_acceptRetryAt != 0) {
+			int retryIn = _acceptRetryAt > _nowMs ? static_cast<int>(_acceptRetryAt - _nowMs) : 0;
+			timeout = timeout < 0 ? retryIn : std::min(timeout, retryIn);
+		}
+		if (_uring->SubmitAndWait(completions, timeout) < 0) {
+			// handle error
+			return false;
+		}
+		_updateClock();
+		for (size_t i = 0; i < completions.size(); ++i) {
+			HandleUringCompletion(completions[i]);
+		}
+
+		// Keepalive PINGs & timeouts that are due
+		_runTimers();
+
+		// Accepting paused after running out of fds, arm it again once the pause is over
+		if (_acceptRetryAt != 0 && _nowMs >= _acceptRetryAt) {
+			_acceptRetryAt = 0;
+			_uring->PrepareMultishotAccept(_listeningFd, _uringUserData(URING_OP_ACCEPT, _listeningFd));
+		}
+
+		// Queue the sends of everything this iteration produced, they go out with the next submit,
+		// & remove closed/disconnected FDs, never in the middle of a handler
+		_settlePending();
+
+		// Every command scoped temporary of this iteration is dead now
+		_arena.Reset();
+	}
+	return true;
+}
+
+// handles a single completion
+void Server::HandleUringCompletion(const IoCompletion &completion) {
+	int fd = _userDataFd(completion.userData);
+	bool current = fd >= 0 && static_cast<size_t>(fd) < _uringSlots.size()
+		&& _userDataGeneration(completion.userData) == (_uringSlots[fd].generation & 0xFFFFFF)
+		&& _clients.Contains(fd);
+
+	switch (_userDataOperation(completion.userData)) {
+		case URING_OP_ACCEPT:
+		{
+			bool rearm = !IoUring::HasMore(completion.flags);
+			if (completion.res >= 0) {
+				// multishot accept does not report the peer, ask for it
+				sockaddr_in clientAddr;
+				socklen_t addrSize = sizeof(clientAddr);
+				std::memset(&clientAddr, 0, sizeof(clientAddr));
+				getpeername(completion.res, reinterpret_cast<sockaddr*>(&clientAddr), &addrSize);
+				_admitClient(completion.res, clientAddr);
+			} else {
+				_admission.CountAcceptError();
+				// out of fds, refuse a pending connection like the readiness loop does
+				if ((completion.res == -EMFILE || completion.res == -ENFILE) && !_refuseWithSpareFd() && rearm) {
+					// the backlog did not shrink, re-arming right away would fail again in a tight loop
+					_acceptRetryAt = _nowMs + URING_ACCEPT_BACKOFF_MS;
+					rearm = false;
+				}
+			}
+			if (rearm) {
+				_uring->PrepareMultishotAccept(_listeningFd, completion.userData);
+			}
+			break;
+		}
+		case URING_OP_WAKE:
+			HandleShardMessages();
+			if (!IoUring::HasMore(completion.flags)) {
+				_uring->PrepareMultishotPoll(_wakeFd, completion.userData);
+			}
+			break;
+		case URING_OP_RECV:
+		{
+			uint16_t bufferId;
+			bool hasBuffer = IoUring::HasBuffer(completion.flags, bufferId);
+			if (current && completion.res > 0 && hasBuffer) {
+				_handleInput(fd, _uring->GetBuffer(bufferId), static_cast<size_t>(completion.res));
+			}
+			if (hasBuffer) {
+				_uring->RecycleBuffer(bufferId);
+			}
+			if (!current || !_clients.Contains(fd)) {
+				break;
+			}
+			if (completion.res == 0) {
+				HandleDisconnection(fd);
+			} else if (completion.res < 0 && completion.res != -ENOBUFS) {
+				_scheduleDisconnect(fd);
+			} else if (!IoUring::HasMore(completion.flags)) {
+				// out of provided buffers or the kernel ended the multishot, re-arm it
+				_uring->PrepareMultishotRecv(fd, completion.userData);
+			}
+			break;
+		}
+		case URING_OP_SEND:
+		{
+			if (!current) {
+				// the client is gone, release its chunks after the last send completed
+				std::map<uint64_t, RetiredSends>::iterator it = _retiredSends.find(completion.userData & ((1ULL << 56) - 1));
+				if (it != _retiredSends.end() && --it->second.sendsInFlight == 0) {
+					_retiredSends.erase(it);
+				}
+				break;
+			}
+			Client &client = _clients[fd];
+			UringSlot &slot = _uringSlots[fd];
+			--slot.sendsInFlight;
+			if (completion.res > 0) {
+				client.ConsumePending(static_cast<size_t>(completion.res));
+			} else if (completion.res < 0 && completion.res != -ECANCELED) {
+				_scheduleDisconnect(fd);
+			}
+			if (slot.sendsInFlight == 0) {
+				client.SetWriteArmed(false);
+				// whatever was queued meanwhile (or cut off by a short send) goes out next
+				if (client.HasPendingOutput() && !client.GetFlushScheduled()) {
+					client.SetFlushScheduled(true);
+					_pendingFlushes.push_back(fd);
+				}
+			}
+			break;
+		}
+		case URING_OP_INTERNAL:
+			break;
+	}
+}
+
+// prepares one linked send per queued chunk, one batch in flight per client keeps the order
+void Server::_submitUringSends(int clientFd) {
+	Client &client = _clients[clientFd];
+	UringSlot &slot = _uringSlots[clientFd];
+	if (slot.sendsInFlight > 0 || !client.HasPendingOutput()) {
+		return;
+	}
+	struct iovec iov[MAX_FLUSH_IOV];
+	int iovCount = client.GetPendingIovecs(iov, MAX_FLUSH_IOV);
+	_uring->ReserveSubmissions(static_cast<unsigned>(iovCount));
+	uint64_t userData = _uringUserData(URING_OP_SEND, clientFd);
+	for (int i = 0; i < iovCount; ++i) {
+		_uring->PrepareSend(clientFd, iov[i].iov_base, iov[i].iov_len, i + 1 < iovCount, userData);
+	}
+	slot.sendsInFlight = static_cast<uint32_t>(iovCount);
+	client.SetWriteArmed(true);
+}
+
+// cancels a client's requests before its fd is closed & keeps in flight send buffers alive
+void Server::_releaseUringClient(int clientFd) {
+	if (clientFd < 0 || static_cast<size_t>(clientFd) >= _uringSlots.size()) {
+		return;
+	}
+	UringSlot &slot = _uringSlots[clientFd];
+	Client *client = _clients.Find(clientFd);
+	if (slot.sendsInFlight > 0 && client) {
+		RetiredSends &retired = _retiredSends[_uringUserData(URING_OP_SEND, clientFd) & ((1ULL << 56) - 1)];
+		retired.sendsInFlight = slot.sendsInFlight;
+		retired.chunks = client->TakeSendQueue();
+	}
+	_uring->CancelFd(clientFd, _uringUserData(URING_OP_INTERNAL, clientFd));
+	slot.sendsInFlight = 0;
+	++slot.generation;
+}
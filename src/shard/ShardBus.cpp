@@ -0,0 +1,265 @@
+//
+// Created on 10/18/26.
+//
+
+#include "ShardBus.hpp"
+#include <unistd.h>
+#include <fcntl.h>
+#include <cerrno>
+#include <stdexcept>
+
+/* --------------------------------------------------------------------------------- */
+/* Constructors & Destructors                                                        */
+/* --------------------------------------------------------------------------------- */
+ShardBus::ShardBus(size_t shardCount, size_t historyBytes) : _historyBytes(historyBytes) {
+	for (size_t i = 0; i < shardCount; ++i) {
+		Mailbox *mailbox = new Mailbox();
+		if (pipe(mailbox->wakeFds) == -1) {
+			delete mailbox;
+			for (size_t j = 0; j < _mailboxes.size(); ++j) {
+				close(_mailboxes[j]->wakeFds[0]);
+				close(_mailboxes[j]->wakeFds[1]);
+				delete _mailboxes[j];
+			}
+			throw std::runtime_error("Failed to create shard wakeup pipe");
+		}
+		fcntl(mailbox->wakeFds[0], F_SETFL, O_NONBLOCK);
+		fcntl(mailbox->wakeFds[1], F_SETFL, O_NONBLOCK);
+		_mailboxes.push_back(mailbox);
+	}
+}
+
+ShardBus::~ShardBus() {
+	for (size_t i = 0; i < _mailboxes.size(); ++i) {
+		close(_mailboxes[i]->wakeFds[0]);
+		close(_mailboxes[i]->wakeFds[1]);
+		delete _mailboxes[i];
+	}
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Getters                                                                           */
+/* --------------------------------------------------------------------------------- */
+// returns the number of shards
+size_t ShardBus::GetShardCount() const {
+	return _mailboxes.size();
+}
+
+// returns the fd a shard polls to learn about new messages
+int ShardBus::GetWakeFd(size_t shard) const {
+	return _mailboxes[shard]->wakeFds[0];
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Mailboxes                                                                         */
+/* --------------------------------------------------------------------------------- */
+// posts a message to a shard, only an empty mailbox needs a wakeup
+void ShardBus::Post(size_t shard, const ShardMessage &msg) const {
+	Mailbox &mailbox = *_mailboxes[shard];
+	bool wasEmpty;
+	{
+		std::lock_guard<std::mutex> guard(mailbox.lock);
+		wasEmpty = mailbox.messages.empty();
+		mailbox.messages.push_back(msg);
+	}
+	if (wasEmpty) {
+		char byte = 1;
+		ssize_t ret = write(mailbox.wakeFds[1], &byte, 1);
+		(void)ret; // a full pipe already guarantees a pending wakeup
+	}
+}
+
+// posts a message to the shards with members in msg.channel or in any of msg.channels, except the sender
+void ShardBus::PostToChannelShards(size_t fromShard, const ShardMessage &msg) const {
+	std::shared_lock<std::shared_mutex> guard(_channelLock);
+	if (msg.channels.empty()) {
+		ChannelDirectory::const_iterator it = _channels.find(msg.channel);
+		if (it == _channels.end()) {
+			return;
+		}
+		const std::vector<size_t> &members = it->second.state.shardMembers;
+		for (size_t i = 0; i < members.size(); ++i) {
+			if (i != fromShard && members[i] > 0) {
+				Post(i, msg);
+			}
+		}
+		return;
+	}
+	// a shard sharing several of the channels still gets the message once
+	std::vector<char> targets(_mailboxes.size(), 0);
+	for (size_t i = 0; i < msg.channels.size(); ++i) {
+		ChannelDirectory::const_iterator it = _channels.find(msg.channels[i]);
+		if (it == _channels.end()) {
+			continue;
+		}
+		const std::vector<size_t> &members = it->second.state.shardMembers;
+		for (size_t j = 0; j < members.size(); ++j) {
+			targets[j] |= members[j] > 0;
+		}
+	}
+	for (size_t i = 0; i < targets.size(); ++i) {
+		if (i != fromShard && targets[i]) {
+			Post(i, msg);
+		}
+	}
+}
+
+// takes all pending messages of a shard
+void ShardBus::Drain(size_t shard, std::vector<ShardMessage> &messages) {
+	Mailbox &mailbox = *_mailboxes[shard];
+	char buffer[64];
+	while (read(mailbox.wakeFds[0], buffer, sizeof(buffer)) > 0) {
+	}
+	messages.clear();
+	std::lock_guard<std::mutex> guard(mailbox.lock);
+	messages.swap(mailbox.messages);
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Nickname Directory                                                                */
+/* --------------------------------------------------------------------------------- */
+// reserves a nickname for a shard, fails if another shard holds it
+bool ShardBus::ClaimNick(const std::string &nick, size_t shard) {
+	std::unique_lock<std::shared_mutex> guard(_nickLock);
+	NickDirectory::iterator it = _nicks.find(nick);
+	if (it != _nicks.end()) {
+		return it->second == shard;
+	}
+	_nicks.emplace(nick, shard);
+	return true;
+}
+
+// releases a nickname held by a shard
+void ShardBus::ReleaseNick(const std::string &nick, size_t shard) {
+	std::unique_lock<std::shared_mutex> guard(_nickLock);
+	NickDirectory::iterator it = _nicks.find(nick);
+	if (it != _nicks.end() && it->second == shard) {
+		_nicks.erase(it);
+	}
+}
+
+// returns the shard owning a nickname, -1 if nobody uses it
+int ShardBus::FindNick(const std::string &nick) const {
+	std::shared_lock<std::shared_mutex> guard(_nickLock);
+	NickDirectory::const_iterator it = _nicks.find(nick);
+	if (it == _nicks.end()) {
+		return -1;
+	}
+	return static_cast<int>(it->second);
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Channel Directory                                                                 */
+/* --------------------------------------------------------------------------------- */
+// checks the limit, the invite & the key of a channel & adds the member, the first one creates the channel
+// the decision & the count happen under one lock, so two shards never both create it or both take its last seat
+JoinResult ShardBus::JoinChannel(const std::string &name, std::string_view key, bool invited, const std::string &nick,
+	size_t shard, ChannelState &state) {
+	std::unique_lock<std::shared_mutex> guard(_channelLock);
+	std::pair<ChannelDirectory::iterator, bool> inserted = _channels.try_emplace(name);
+	ChannelEntry &entry = inserted.first->second;
+	ChannelState &channel = entry.state;
+	JoinResult result = JOIN_OK;
+	if (inserted.second) {
+		channel.name = name;
+		channel.key.assign(key.data(), key.size());
+		channel.shardMembers.assign(_mailboxes.size(), 0);
+		entry.history.SetBudget(_historyBytes);
+		result = JOIN_CREATED;
+	} else if (channel.userLimit > 0 && channel.userCount >= channel.userLimit) {
+		result = JOIN_FULL;
+	} else if (channel.inviteOnly && !invited) {
+		result = JOIN_INVITE_ONLY;
+	} else if (!channel.key.empty() && key != channel.key) {
+		result = JOIN_BAD_KEY;
+	}
+	if (result == JOIN_OK || result == JOIN_CREATED) {
+		++channel.userCount;
+		++channel.shardMembers[shard];
+		entry.members[nick] = result == JOIN_CREATED;
+	}
+	state = channel;
+	return result;
+}
+
+// removes a member that left a channel
+void ShardBus::LeaveChannel(const std::string &name, const std::string &nick, size_t shard) {
+	std::unique_lock<std::shared_mutex> guard(_channelLock);
+	ChannelDirectory::iterator it = _channels.find(name);
+	if (it == _channels.end()) {
+		return;
+	}
+	ChannelState &channel = it->second.state;
+	if (channel.userCount > 0) {
+		--channel.userCount;
+	}
+	if (channel.shardMembers[shard] > 0) {
+		--channel.shardMembers[shard];
+	}
+	it->second.members.erase(nick);
+}
+
+// copies the state of a channel, false if it was never created
+bool ShardBus::FindChannel(const std::string &name, ChannelState &state) const {
+	std::shared_lock<std::shared_mutex> guard(_channelLock);
+	ChannelDirectory::const_iterator it = _channels.find(name);
+	if (it == _channels.end()) {
+		return false;
+	}
+	state = it->second.state;
+	return true;
+}
+
+// moves a member to its new nick, keeping its operator status
+void ShardBus::RenameMember(const std::string &name, const std::string &oldNick, const std::string &newNick) {
+	std::unique_lock<std::shared_mutex> guard(_channelLock);
+	ChannelDirectory::iterator it = _channels.find(name);
+	if (it == _channels.end()) {
+		return;
+	}
+	ChannelRoster::iterator member = it->second.members.find(oldNick);
+	if (member == it->second.members.end()) {
+		return;
+	}
+	bool isOperator = member->second;
+	it->second.members.erase(member);
+	it->second.members[newNick] = isOperator;
+}
+
+// gives or takes the operator status of a member, nicks that are not on the channel are ignored
+void ShardBus::SetMemberOperator(const std::string &name, const std::string &nick, bool isOperator) {
+	std::unique_lock<std::shared_mutex> guard(_channelLock);
+	ChannelDirectory::iterator it = _channels.find(name);
+	if (it == _channels.end()) {
+		return;
+	}
+	ChannelRoster::iterator member = it->second.members.find(nick);
+	if (member != it->second.members.end()) {
+		member->second = isOperator;
+	}
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Channel History                                                                   */
+/* --------------------------------------------------------------------------------- */
+// stores a PRIVMSG of a channel, the directory lock is shared so only shards writing the same channel wait
+void ShardBus::AppendHistory(const std::string &name, uint64_t msgid, int64_t timeMs, std::string_view line) {
+	std::shared_lock<std::shared_mutex> guard(_channelLock);
+	ChannelDirectory::iterator it = _channels.find(name);
+	if (it == _channels.end()) {
+		return;
+	}
+	std::lock_guard<std::mutex> historyGuard(it->second.historyLock);
+	it->second.history.Append(msgid, timeMs, line);
+}
+
+// sums the bytes the histories of all channels use
+void ShardBus::GetHistoryUsage(size_t &bytes, size_t &channels) const {
+	std::shared_lock<std::shared_mutex> guard(_channelLock);
+	bytes = 0;
+	channels = _channels.size();
+	for (ChannelDirectory::const_iterator it = _channels.begin(); it != _channels.end(); ++it) {
+		std::lock_guard<std::mutex> historyGuard(it->second.historyLock);
+		bytes += it->second.history.GetUsedBytes();
+	}
+}
@@ -0,0 +1,151 @@
+//
+// Created on 10/18/26.
+//
+
+#include "TimerWheel.hpp"
+
+/* --------------------------------------------------------------------------------- */
+/* Constructors & Destructors                                                        */
+/* --------------------------------------------------------------------------------- */
+TimerWheel::TimerWheel() : _currentTick(0), _count(0) {
+	for (int i = 0; i < TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS; ++i) {
+		_slots[i] = -1;
+	}
+}
+
+TimerWheel::~TimerWheel() {}
+
+/* --------------------------------------------------------------------------------- */
+/* Timers                                                                            */
+/* --------------------------------------------------------------------------------- */
+// starts counting ticks from nowMs, must be called before the first Schedule
+void TimerWheel::Start(uint64_t nowMs) {
+	_currentTick = nowMs / TIMER_TICK_MS;
+}
+
+// (re)arms the timer of id to fire at expiryMs
+void TimerWheel::Schedule(int id, uint64_t expiryMs) {
+	if (static_cast<size_t>(id) >= _nodes.size()) {
+		Node unused = {-1, -1, 0, -1};
+		_nodes.resize(id + 1, unused);
+	}
+	if (_nodes[id].slot != -1) {
+		_unlink(id);
+	}
+	// round up, a timer never fires early
+	uint64_t expiryTick = (expiryMs + TIMER_TICK_MS - 1) / TIMER_TICK_MS;
+	_nodes[id].expiryTick = expiryTick > _currentTick ? expiryTick : _currentTick + 1;
+	_link(id);
+	++_count;
+}
+
+// disarms the timer of id, nothing happens if it is not armed
+void TimerWheel::Cancel(int id) {
+	if (IsScheduled(id)) {
+		_unlink(id);
+	}
+}
+
+// returns if the timer of id is armed
+bool TimerWheel::IsScheduled(int id) const {
+	return id >= 0 && static_cast<size_t>(id) < _nodes.size() && _nodes[id].slot != -1;
+}
+
+// returns the number of armed timers
+size_t TimerWheel::GetCount() const {
+	return _count;
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Slots                                                                             */
+/* --------------------------------------------------------------------------------- */
+// puts a node on the lowest level whose range still covers its expiry
+void TimerWheel::_link(int id) {
+	Node &node = _nodes[id];
+	int level = 0;
+	while (level < TIMER_WHEEL_LEVELS - 1 &&
+		(node.expiryTick >> (TIMER_WHEEL_BITS * (level + 1))) != (_currentTick >> (TIMER_WHEEL_BITS * (level + 1)))) {
+		++level;
+	}
+	int slot = level * TIMER_WHEEL_SLOTS +
+		static_cast<int>((node.expiryTick >> (TIMER_WHEEL_BITS * level)) & (TIMER_WHEEL_SLOTS - 1));
+	node.slot = slot;
+	node.prev = -1;
+	node.next = _slots[slot];
+	if (node.next != -1) {
+		_nodes[node.next].prev = id;
+	}
+	_slots[slot] = id;
+}
+
+// takes a node out of its slot list
+void TimerWheel::_unlink(int id) {
+	Node &node = _nodes[id];
+	if (node.prev != -1) {
+		_nodes[node.prev].next = node.next;
+	} else {
+		_slots[node.slot] = node.next;
+	}
+	if (node.next != -1) {
+		_nodes[node.next].prev = node.prev;
+	}
+	node.slot = -1;
+	--_count;
+}
+
+// redistributes the slot of a higher level the current tick just entered
+void TimerWheel::_cascade(int level) {
+	int slot = level * TIMER_WHEEL_SLOTS +
+		static_cast<int>((_currentTick >> (TIMER_WHEEL_BITS * level)) & (TIMER_WHEEL_SLOTS - 1));
+	int id = _slots[slot];
+	_slots[slot] = -1;
+	while (id != -1) {
+		int next = _nodes[id].next;
+		_link(id);
+		id = next;
+	}
+}
+
+/* --------------------------------------------------------------------------------- */
+/* Event Loop                                                                        */
+/* --------------------------------------------------------------------------------- */
+// moves the wheel to nowMs & appends the ids of every expired timer
+void TimerWheel::Advance(uint64_t nowMs, std::vector<int> &expired) {
+	uint64_t targetTick = nowMs / TIMER_TICK_MS;
+	while (_currentTick < targetTick) {
+		if (_count == 0) {
+			_currentTick = targetTick;
+			break;
+		}
+		++_currentTick;
+		// entering a new block of a level, highest first so entries can fall through several levels
+		int top = 0;
+		while (top < TIMER_WHEEL_LEVELS - 1 &&
+			(_currentTick & ((1ULL << (TIMER_WHEEL_BITS * (top + 1))) - 1)) == 0) {
+			++top;
+		}
+		for (int level = top; level > 0; --level) {
+			_cascade(level);
+		}
+		int slot = static_cast<int>(_currentTick & (TIMER_WHEEL_SLOTS - 1));
+		while (_slots[slot] != -1) {
+			int id = _slots[slot];
+			_unlink(id);
+			expired.push_back(id);
+		}
+	}
+}
+
+// returns how long the event loop may sleep, -1 if no timer is armed
+int TimerWheel::GetTimeout(uint64_t nowMs) const {
+	if (_count == 0) {
+		return -1;
+	}
+	// next non empty slot of the lowest level, or the next cascade, whichever comes first
+	uint64_t tick = _currentTick + 1;
+	while ((tick & (TIMER_WHEEL_SLOTS - 1)) != 0 && _slots[tick & (TIMER_WHEEL_SLOTS - 1)] == -1) {
+		++tick;
+	}
+	uint64_t wakeMs = tick * TIMER_TICK_MS;
+	return wakeMs > nowMs ? static_cast<int>(wakeMs - nowMs) : 0;
+}